@@ -0,0 +1,370 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamCloudChunkedSave.h"
+
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+	constexpr uint32 ManifestMagic = 0x5342434D;  // SBCM
+	constexpr int32 ManifestVersion = 1;
+
+	// Chunks average about MinChunkSize + 64 KiB, small enough that an edit rewrites little and large enough to stay well below the cloud file count limit
+	constexpr int32 MinChunkSize = 16 * 1024;
+	constexpr int32 MaxChunkSize = 256 * 1024;
+	constexpr uint64 BoundaryMask = 0xFFFF000000000000ull;
+
+	// Random values for the gear rolling hash, generated from a fixed seed so chunk boundaries never change between builds
+	struct FGearTable
+	{
+		uint64 Values[256];
+
+		FGearTable()
+		{
+			uint64 State = 0x9E3779B97F4A7C15ull;
+			for (uint64& Value : Values)
+			{
+				// SplitMix64
+				State += 0x9E3779B97F4A7C15ull;
+				uint64 Z = State;
+				Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ull;
+				Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBull;
+				Value = Z ^ (Z >> 31);
+			}
+		}
+	};
+
+	const FGearTable& GetGearTable()
+	{
+		static const FGearTable GearTable;
+		return GearTable;
+	}
+
+	template <typename T>
+	TFuture<T> MakeReadyFuture(T&& Value)
+	{
+		TPromise<T> Promise;
+		Promise.SetValue(MoveTemp(Value));
+		return Promise.GetFuture();
+	}
+}  // namespace
+
+TFuture<ESteamResult> USteamCloudChunkedSave::SaveAsync(const FString& SaveName, TArray<uint8>&& Data)
+{
+	if (m_SavesInFlight.Contains(SaveName))
+	{
+		return MakeReadyFuture(ESteamResult::Busy);
+	}
+	m_SavesInFlight.Add(SaveName);
+
+	TSharedRef<FSaveOperation> Operation = MakeShared<FSaveOperation>();
+	Operation->SaveName = SaveName;
+	Operation->BytesWritten = 0;
+	Operation->Result = ESteamResult::OK;
+	SplitIntoChunks(Data, Operation->Chunks);
+	TFuture<ESteamResult> Future = Operation->Promise.GetFuture();
+
+	// Held until every write was issued so a write failing right away doesn't finish the save early
+	Operation->NumPendingWrites = 1;
+
+	// Making space for one write forgets the least recently used files, which may be chunks this save reuses without writing them.
+	// Every chunk of the new manifest is critical from before the first write until the save finished.
+	USteamRemoteStorage* const RemoteStorage = USteamRemoteStorage::GetSteamRemoteStorage();
+	Operation->ChunkNames.Reserve(Operation->Chunks.Num());
+	for (const FChunk& Chunk : Operation->Chunks)
+	{
+		const FString& ChunkName = Operation->ChunkNames.Add_GetRef(GetChunkName(SaveName, Chunk.Hash));
+		RemoteStorage->SetFileCritical(ChunkName, true);
+	}
+
+	TSet<FSHAHash> WrittenChunks;
+	int64 Offset = 0;
+	for (int32 i = 0; i < Operation->Chunks.Num(); i++)
+	{
+		const FChunk& Chunk = Operation->Chunks[i];
+		const int64 ChunkOffset = Offset;
+		Offset += Chunk.Size;
+
+		bool bAlreadyWritten = false;
+		WrittenChunks.Add(Chunk.Hash, &bAlreadyWritten);
+		if (bAlreadyWritten)
+		{
+			continue;
+		}
+
+		// Chunks are named after their content, a persisted file with the same name and size already holds these bytes
+		const FString& ChunkName = Operation->ChunkNames[i];
+		FSteamCloudFile Existing;
+		if (RemoteStorage->GetCloudFile(ChunkName, Existing) && Existing.bPersisted && Existing.Size == Chunk.Size)
+		{
+			continue;
+		}
+
+		TArray<uint8> Buffer = RemoteStorage->AcquireBuffer();
+		Buffer.Append(Data.GetData() + ChunkOffset, Chunk.Size);
+
+		Operation->NumPendingWrites++;
+		Operation->BytesWritten += Chunk.Size;
+		RemoteStorage->WriteFileAsync(ChunkName, MoveTemp(Buffer)).Next([this, Operation](ESteamResult Result) { HandleChunkWritten(Operation, Result); });
+	}
+
+	Data.Empty();
+	HandleChunkWritten(Operation, ESteamResult::OK);
+	return Future;
+}
+
+TFuture<FSteamCloudReadResult> USteamCloudChunkedSave::LoadAsync(const FString& SaveName)
+{
+	TSharedRef<FLoadOperation> Operation = MakeShared<FLoadOperation>();
+	Operation->SaveName = SaveName;
+	Operation->NumPendingReads = 0;
+	Operation->Result = ESteamResult::OK;
+	TFuture<FSteamCloudReadResult> Future = Operation->Promise.GetFuture();
+
+	USteamRemoteStorage::GetSteamRemoteStorage()->ReadFileAsync(GetManifestName(SaveName)).Next([this, Operation](const FSteamCloudReadResult& ReadResult) { HandleManifestRead(Operation, ReadResult); });
+	return Future;
+}
+
+bool USteamCloudChunkedSave::DeleteSave(const FString& SaveName)
+{
+	if (m_SavesInFlight.Contains(SaveName))
+	{
+		return false;
+	}
+
+	USteamRemoteStorage* const RemoteStorage = USteamRemoteStorage::GetSteamRemoteStorage();
+	const bool bDeleted = RemoteStorage->FileDelete(GetManifestName(SaveName));
+	DeleteUnusedChunks(SaveName, TArray<FChunk>());
+	m_LastBytesWritten.Remove(SaveName);
+	return bDeleted;
+}
+
+void USteamCloudChunkedSave::SplitIntoChunks(const TArray<uint8>& Data, TArray<FChunk>& Chunks)
+{
+	const uint64* const Gear = GetGearTable().Values;
+	const uint8* const Bytes = Data.GetData();
+	const int32 DataSize = Data.Num();
+
+	Chunks.Reset();
+	for (int32 Start = 0; Start < DataSize;)
+	{
+		const int32 End = FMath::Min(Start + MaxChunkSize, DataSize);
+		int32 Cut = End;
+
+		// No boundary can be placed before the minimum size, so the hash only needs to cover the 64 bytes that precede it
+		uint64 Hash = 0;
+		for (int32 i = Start + MinChunkSize - 64; i < End; i++)
+		{
+			Hash = (Hash << 1) + Gear[Bytes[i]];
+			if (i + 1 - Start >= MinChunkSize && (Hash & BoundaryMask) == 0)
+			{
+				Cut = i + 1;
+				break;
+			}
+		}
+
+		FChunk& Chunk = Chunks.AddDefaulted_GetRef();
+		Chunk.Size = Cut - Start;
+		FSHA1::HashBuffer(Bytes + Start, Chunk.Size, Chunk.Hash.Hash);
+		Start = Cut;
+	}
+}
+
+bool USteamCloudChunkedSave::SerializeManifest(FArchive& Ar, TArray<FChunk>& Chunks, int64& TotalSize)
+{
+	uint32 Magic = ManifestMagic;
+	int32 Version = ManifestVersion;
+	Ar << Magic << Version;
+	if (Magic != ManifestMagic || Version != ManifestVersion)
+	{
+		return false;
+	}
+
+	Ar << TotalSize << Chunks;
+	if (Ar.IsError())
+	{
+		return false;
+	}
+
+	int64 ChunksSize = 0;
+	for (const FChunk& Chunk : Chunks)
+	{
+		if (Chunk.Size <= 0 || Chunk.Size > MaxChunkSize)
+		{
+			return false;
+		}
+		ChunksSize += Chunk.Size;
+	}
+	return ChunksSize == TotalSize && TotalSize <= MAX_int32;
+}
+
+void USteamCloudChunkedSave::HandleChunkWritten(const TSharedRef<FSaveOperation>& Operation, ESteamResult Result)
+{
+	if (Result != ESteamResult::OK && Operation->Result == ESteamResult::OK)
+	{
+		Operation->Result = Result;
+	}
+
+	if (--Operation->NumPendingWrites > 0)
+	{
+		return;
+	}
+
+	// The previous manifest stays valid until every chunk of the new one is in the cloud
+	if (Operation->Result != ESteamResult::OK)
+	{
+		FinishSave(Operation, Operation->Result);
+		return;
+	}
+	WriteManifest(Operation);
+}
+
+void USteamCloudChunkedSave::WriteManifest(const TSharedRef<FSaveOperation>& Operation)
+{
+	USteamRemoteStorage* const RemoteStorage = USteamRemoteStorage::GetSteamRemoteStorage();
+	TArray<uint8> Buffer = RemoteStorage->AcquireBuffer();
+	FMemoryWriter Ar(Buffer);
+
+	int64 TotalSize = 0;
+	for (const FChunk& Chunk : Operation->Chunks)
+	{
+		TotalSize += Chunk.Size;
+	}
+	SerializeManifest(Ar, Operation->Chunks, TotalSize);
+
+	Operation->BytesWritten += Buffer.Num();
+	RemoteStorage->WriteFileAsync(GetManifestName(Operation->SaveName), MoveTemp(Buffer)).Next([this, Operation](ESteamResult Result) {
+		if (Result == ESteamResult::OK)
+		{
+			DeleteUnusedChunks(Operation->SaveName, Operation->Chunks);
+		}
+		FinishSave(Operation, Result);
+	});
+}
+
+void USteamCloudChunkedSave::FinishSave(const TSharedRef<FSaveOperation>& Operation, ESteamResult Result)
+{
+	USteamRemoteStorage* const RemoteStorage = USteamRemoteStorage::GetSteamRemoteStorage();
+	for (const FString& ChunkName : Operation->ChunkNames)
+	{
+		RemoteStorage->SetFileCritical(ChunkName, false);
+	}
+
+	m_SavesInFlight.Remove(Operation->SaveName);
+	if (Result == ESteamResult::OK)
+	{
+		m_LastBytesWritten.Add(Operation->SaveName, Operation->BytesWritten);
+	}
+	Operation->Promise.SetValue(Result);
+}
+
+void USteamCloudChunkedSave::DeleteUnusedChunks(const FString& SaveName, const TArray<FChunk>& Chunks)
+{
+	TSet<FString> UsedChunks;
+	UsedChunks.Reserve(Chunks.Num());
+	for (const FChunk& Chunk : Chunks)
+	{
+		UsedChunks.Add(GetChunkName(SaveName, Chunk.Hash));
+	}
+
+	USteamRemoteStorage* const RemoteStorage = USteamRemoteStorage::GetSteamRemoteStorage();
+	TArray<FSteamCloudFile> Files;
+	RemoteStorage->GetCloudFiles(Files);
+
+	const FString ChunkPrefix = GetChunkPrefix(SaveName);
+	for (const FSteamCloudFile& File : Files)
+	{
+		if (File.FileName.StartsWith(ChunkPrefix) && !UsedChunks.Contains(File.FileName))
+		{
+			RemoteStorage->FileDelete(File.FileName);
+		}
+	}
+}
+
+void USteamCloudChunkedSave::HandleManifestRead(const TSharedRef<FLoadOperation>& Operation, const FSteamCloudReadResult& ReadResult)
+{
+	if (ReadResult.Result != ESteamResult::OK)
+	{
+		Operation->Result = ReadResult.Result;
+		FinishLoad(Operation);
+		return;
+	}
+
+	FMemoryReader Ar(ReadResult.Data);
+	TArray<FChunk> Chunks;
+	int64 TotalSize = 0;
+	if (!SerializeManifest(Ar, Chunks, TotalSize))
+	{
+		Operation->Result = ESteamResult::DataCorruption;
+		FinishLoad(Operation);
+		return;
+	}
+
+	// A chunk used more than once is read once and copied to each of its offsets
+	TMap<FSHAHash, TArray<int32>> ChunkOffsets;
+	TMap<FSHAHash, int32> ChunkSizes;
+	int32 Offset = 0;
+	for (const FChunk& Chunk : Chunks)
+	{
+		ChunkOffsets.FindOrAdd(Chunk.Hash).Add(Offset);
+		ChunkSizes.Add(Chunk.Hash, Chunk.Size);
+		Offset += Chunk.Size;
+	}
+
+	Operation->Data.SetNumUninitialized((int32)TotalSize);
+	Operation->NumPendingReads = ChunkOffsets.Num();
+	if (Operation->NumPendingReads == 0)
+	{
+		FinishLoad(Operation);
+		return;
+	}
+
+	// Every chunk is requested at once, Steam reads them in parallel
+	USteamRemoteStorage* const RemoteStorage = USteamRemoteStorage::GetSteamRemoteStorage();
+	for (TPair<FSHAHash, TArray<int32>>& Entry : ChunkOffsets)
+	{
+		const FSHAHash Hash = Entry.Key;
+		const int32 Size = ChunkSizes[Hash];
+		RemoteStorage->ReadFileAsync(GetChunkName(Operation->SaveName, Hash)).Next([this, Operation, Hash, Size, Offsets = MoveTemp(Entry.Value)](const FSteamCloudReadResult& ChunkRead) {
+			if (Operation->Result == ESteamResult::OK && ChunkRead.Result != ESteamResult::OK)
+			{
+				Operation->Result = ChunkRead.Result;
+			}
+			else if (Operation->Result == ESteamResult::OK)
+			{
+				FSHAHash ReadHash;
+				if (ChunkRead.Data.Num() == Size)
+				{
+					FSHA1::HashBuffer(ChunkRead.Data.GetData(), Size, ReadHash.Hash);
+				}
+
+				if (ReadHash != Hash)
+				{
+					Operation->Result = ESteamResult::DataCorruption;
+				}
+				else
+				{
+					for (const int32 ChunkOffset : Offsets)
+					{
+						FMemory::Memcpy(Operation->Data.GetData() + ChunkOffset, ChunkRead.Data.GetData(), Size);
+					}
+				}
+			}
+
+			if (--Operation->NumPendingReads == 0)
+			{
+				FinishLoad(Operation);
+			}
+		});
+	}
+}
+
+void USteamCloudChunkedSave::FinishLoad(const TSharedRef<FLoadOperation>& Operation)
+{
+	if (Operation->Result != ESteamResult::OK)
+	{
+		Operation->Data.Empty();
+	}
+	Operation->Promise.SetValue(FSteamCloudReadResult{Operation->Result, MoveTemp(Operation->Data)});
+}
@@ -0,0 +1,295 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamCloudSaveArchive.h"
+
+#include "Async/Async.h"
+#include "Core/SteamRemoteStorage.h"
+#include "Misc/Compression.h"
+
+namespace
+{
+	constexpr uint32 CloudSaveMagic = 0x53424353;  // 'SBCS'
+	constexpr uint32 CloudSaveVersion = 1;
+
+	// Magic, version, chunk size and compression format
+	constexpr int32 FileHeaderSize = 13;
+
+	// Stored size and uncompressed size of the chunk. A chunk whose sizes match is stored uncompressed.
+	constexpr int32 ChunkHeaderSize = 8;
+
+	enum class ECloudSaveCompression : uint8
+	{
+		Zlib = 1,
+		Oodle = 2
+	};
+
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 27
+	constexpr ECloudSaveCompression WriteCompression = ECloudSaveCompression::Oodle;
+#else
+	constexpr ECloudSaveCompression WriteCompression = ECloudSaveCompression::Zlib;
+#endif
+
+	FName GetCompressionFormat(ECloudSaveCompression Compression)
+	{
+		switch (Compression)
+		{
+			case ECloudSaveCompression::Zlib: return NAME_Zlib;
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 27
+			case ECloudSaveCompression::Oodle: return NAME_Oodle;
+#endif
+			default: return NAME_None;
+		}
+	}
+
+	// Steam only runs on little endian platforms, the headers are copied as is
+	void WriteUInt32(uint8* Dest, uint32 Value) { FMemory::Memcpy(Dest, &Value, sizeof(uint32)); }
+
+	uint32 ReadUInt32(const uint8* Src)
+	{
+		uint32 Value;
+		FMemory::Memcpy(&Value, Src, sizeof(uint32));
+		return Value;
+	}
+
+	// Runs on a worker thread
+	void CompressChunk(FName Format, const TArray<uint8>& Chunk, TArray<uint8>& Compressed)
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(Format, Chunk.Num());
+		Compressed.SetNumUninitialized(ChunkHeaderSize + FMath::Max(CompressedSize, Chunk.Num()), false);
+
+		if (!FCompression::CompressMemory(Format, Compressed.GetData() + ChunkHeaderSize, CompressedSize, Chunk.GetData(), Chunk.Num()) || CompressedSize >= Chunk.Num())
+		{
+			CompressedSize = Chunk.Num();
+			FMemory::Memcpy(Compressed.GetData() + ChunkHeaderSize, Chunk.GetData(), Chunk.Num());
+		}
+
+		WriteUInt32(Compressed.GetData(), (uint32)CompressedSize);
+		WriteUInt32(Compressed.GetData() + 4, (uint32)Chunk.Num());
+		Compressed.SetNum(ChunkHeaderSize + CompressedSize, false);
+	}
+}  // namespace
+
+FSteamCloudSaveWriter::FSteamCloudSaveWriter(const FString& FileName, int32 ChunkSize) :
+	m_FileName(FileName), m_WriteHandle(k_UGCFileStreamHandleInvalid), m_ChunkSize(FMath::Max(ChunkSize, 1024)), m_TotalSize(0)
+{
+	SetIsSaving(true);
+	SetIsPersistent(true);
+
+	m_WriteHandle = USteamRemoteStorage::GetSteamRemoteStorage()->FileWriteStreamOpen(FileName);
+	if (m_WriteHandle == k_UGCFileStreamHandleInvalid)
+	{
+		SetError();
+		return;
+	}
+
+	uint8 Header[FileHeaderSize];
+	WriteUInt32(Header, CloudSaveMagic);
+	WriteUInt32(Header + 4, CloudSaveVersion);
+	WriteUInt32(Header + 8, (uint32)m_ChunkSize);
+	Header[12] = (uint8)WriteCompression;
+	if (!SteamRemoteStorage()->FileWriteStreamWriteChunk(m_WriteHandle, Header, FileHeaderSize))
+	{
+		Cancel();
+		return;
+	}
+
+	m_FillingChunk.Reserve(m_ChunkSize);
+}
+
+FSteamCloudSaveWriter::~FSteamCloudSaveWriter()
+{
+	if (IsOpen())
+	{
+		// The worker still references the chunk buffers
+		if (m_Compression.IsValid())
+		{
+			m_Compression.Wait();
+		}
+		Cancel();
+	}
+}
+
+bool FSteamCloudSaveWriter::Close()
+{
+	if (!IsOpen())
+	{
+		return false;
+	}
+
+	if (m_FillingChunk.Num() > 0)
+	{
+		SubmitChunk();
+	}
+	WriteCompressedChunk();
+
+	if (IsError() || !IsOpen())
+	{
+		Cancel();
+		return false;
+	}
+
+	const bool bClosed = USteamRemoteStorage::GetSteamRemoteStorage()->FileWriteStreamClose(m_WriteHandle);
+	m_WriteHandle = k_UGCFileStreamHandleInvalid;
+	if (!bClosed)
+	{
+		SetError();
+	}
+	return bClosed;
+}
+
+void FSteamCloudSaveWriter::Serialize(void* Data, int64 Num)
+{
+	if (!IsOpen())
+	{
+		SetError();
+		return;
+	}
+
+	const uint8* Src = (const uint8*)Data;
+	while (Num > 0)
+	{
+		const int32 Count = (int32)FMath::Min<int64>(Num, m_ChunkSize - m_FillingChunk.Num());
+		m_FillingChunk.Append(Src, Count);
+		Src += Count;
+		Num -= Count;
+		m_TotalSize += Count;
+
+		if (m_FillingChunk.Num() == m_ChunkSize)
+		{
+			SubmitChunk();
+		}
+	}
+}
+
+void FSteamCloudSaveWriter::SubmitChunk()
+{
+	// Only one chunk is compressed at a time, the previous one is written out before its buffers are reused
+	WriteCompressedChunk();
+	if (!IsOpen())
+	{
+		m_FillingChunk.Reset();
+		return;
+	}
+
+	Swap(m_FillingChunk, m_CompressingChunk);
+	m_FillingChunk.Reset();
+
+	m_Compression = Async(EAsyncExecution::TaskGraph, [this]() {
+		CompressChunk(GetCompressionFormat(WriteCompression), m_CompressingChunk, m_CompressedChunk);
+	});
+}
+
+void FSteamCloudSaveWriter::WriteCompressedChunk()
+{
+	if (!m_Compression.IsValid())
+	{
+		return;
+	}
+
+	m_Compression.Wait();
+	m_Compression.Reset();
+
+	if (IsOpen() && !SteamRemoteStorage()->FileWriteStreamWriteChunk(m_WriteHandle, m_CompressedChunk.GetData(), m_CompressedChunk.Num()))
+	{
+		Cancel();
+	}
+}
+
+void FSteamCloudSaveWriter::Cancel()
+{
+	if (IsOpen())
+	{
+		USteamRemoteStorage::GetSteamRemoteStorage()->FileWriteStreamCancel(m_WriteHandle);
+		m_WriteHandle = k_UGCFileStreamHandleInvalid;
+	}
+	SetError();
+}
+
+FSteamCloudSaveReader::FSteamCloudSaveReader(TArray<uint8>&& FileData) :
+	m_FileData(MoveTemp(FileData)), m_FileOffset(FileHeaderSize), m_ChunkOffset(0), m_Position(0), m_TotalSize(0)
+{
+	SetIsLoading(true);
+	SetIsPersistent(true);
+
+	if (m_FileData.Num() < FileHeaderSize || ReadUInt32(m_FileData.GetData()) != CloudSaveMagic || ReadUInt32(m_FileData.GetData() + 4) != CloudSaveVersion)
+	{
+		SetError();
+		return;
+	}
+
+	m_CompressionFormat = GetCompressionFormat((ECloudSaveCompression)m_FileData[12]);
+	if (m_CompressionFormat.IsNone())
+	{
+		SetError();
+		return;
+	}
+
+	// Walk the chunk headers once so a truncated file is rejected before anything is deserialized
+	const int32 MaxChunkSize = (int32)ReadUInt32(m_FileData.GetData() + 8);
+	for (int32 Offset = FileHeaderSize; Offset < m_FileData.Num();)
+	{
+		if (m_FileData.Num() - Offset < ChunkHeaderSize)
+		{
+			SetError();
+			return;
+		}
+
+		const uint32 StoredSize = ReadUInt32(m_FileData.GetData() + Offset);
+		const uint32 ChunkSize = ReadUInt32(m_FileData.GetData() + Offset + 4);
+		if (ChunkSize > (uint32)MaxChunkSize || StoredSize > ChunkSize || StoredSize > (uint32)(m_FileData.Num() - Offset - ChunkHeaderSize))
+		{
+			SetError();
+			return;
+		}
+
+		Offset += ChunkHeaderSize + StoredSize;
+		m_TotalSize += ChunkSize;
+	}
+
+	m_Chunk.Reserve(MaxChunkSize);
+}
+
+void FSteamCloudSaveReader::Serialize(void* Data, int64 Num)
+{
+	uint8* Dest = (uint8*)Data;
+	while (Num > 0)
+	{
+		if (IsError() || (m_ChunkOffset == m_Chunk.Num() && !DecompressNextChunk()))
+		{
+			SetError();
+			FMemory::Memzero(Dest, Num);
+			return;
+		}
+
+		const int32 Count = (int32)FMath::Min<int64>(Num, m_Chunk.Num() - m_ChunkOffset);
+		FMemory::Memcpy(Dest, m_Chunk.GetData() + m_ChunkOffset, Count);
+		m_ChunkOffset += Count;
+		m_Position += Count;
+		Dest += Count;
+		Num -= Count;
+	}
+}
+
+bool FSteamCloudSaveReader::DecompressNextChunk()
+{
+	if (m_FileOffset >= m_FileData.Num())
+	{
+		return false;
+	}
+
+	// The headers were validated in the constructor
+	const int32 StoredSize = (int32)ReadUInt32(m_FileData.GetData() + m_FileOffset);
+	const int32 ChunkSize = (int32)ReadUInt32(m_FileData.GetData() + m_FileOffset + 4);
+	const uint8* const Stored = m_FileData.GetData() + m_FileOffset + ChunkHeaderSize;
+	m_FileOffset += ChunkHeaderSize + StoredSize;
+
+	m_Chunk.SetNumUninitialized(ChunkSize, false);
+	m_ChunkOffset = 0;
+
+	if (StoredSize == ChunkSize)
+	{
+		FMemory::Memcpy(m_Chunk.GetData(), Stored, ChunkSize);
+		return true;
+	}
+	return FCompression::UncompressMemory(m_CompressionFormat, m_Chunk.GetData(), ChunkSize, Stored, StoredSize);
+}
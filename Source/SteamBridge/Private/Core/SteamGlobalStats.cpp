@@ -0,0 +1,223 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamGlobalStats.h"
+
+#include "Core/SteamUserStats.h"
+
+namespace
+{
+	// RequestGlobalStats doesn't return more than 60 days of history
+	constexpr int32 MaxHistoryDays = 60;
+}  // namespace
+
+USteamGlobalStats::USteamGlobalStats() :
+	m_NumInt64Stats(0), m_NumDoubleStats(0), m_HistoryDays(0), m_RequestedHistoryDays(0), m_bRequestPending(false)
+{
+}
+
+void USteamGlobalStats::RegisterStats(const TArray<FString>& Int64StatNames, const TArray<FString>& DoubleStatNames)
+{
+	USteamUserStats* const UserStats = USteamUserStats::GetSteamUserStats();
+	auto Register = [this, UserStats](const FString& StatName, bool bDouble) {
+		if (StatName.IsEmpty() || m_StatIndices.Contains(StatName))
+		{
+			return;
+		}
+
+		FGlobalStat& Stat = m_Stats.AddDefaulted_GetRef();
+		Stat.Handle = UserStats->MakeStatHandle(StatName);
+		Stat.bDouble = bDouble;
+		Stat.Column = bDouble ? m_NumDoubleStats++ : m_NumInt64Stats++;
+		Stat.NumDays = 0;
+		m_StatIndices.Add(StatName, m_Stats.Num() - 1);
+	};
+
+	for (const FString& StatName : Int64StatNames)
+	{
+		Register(StatName, false);
+	}
+
+	for (const FString& StatName : DoubleStatNames)
+	{
+		Register(StatName, true);
+	}
+
+	// New columns stay empty until the next request
+	m_Int64History.SetNumZeroed(m_NumInt64Stats * m_HistoryDays);
+	m_DoubleHistory.SetNumZeroed(m_NumDoubleStats * m_HistoryDays);
+	m_Int64Totals.SetNumZeroed(m_NumInt64Stats);
+	m_DoubleTotals.SetNumZeroed(m_NumDoubleStats);
+}
+
+bool USteamGlobalStats::RequestGlobalStats(int32 HistoryDays)
+{
+	if (m_bRequestPending)
+	{
+		return false;
+	}
+
+	USteamUserStats::GetSteamUserStats()->m_OnGlobalStatsReceived.AddUniqueDynamic(this, &USteamGlobalStats::HandleGlobalStatsReceived);
+
+	m_RequestedHistoryDays = FMath::Clamp(HistoryDays, 0, MaxHistoryDays);
+	m_bRequestPending = SteamUserStats()->RequestGlobalStats(m_RequestedHistoryDays) != k_uAPICallInvalid;
+	return m_bRequestPending;
+}
+
+bool USteamGlobalStats::GetTotalInt64(const FString& StatName, int64& Total) const
+{
+	const FGlobalStat* const Stat = FindStat(StatName);
+	if (Stat == nullptr)
+	{
+		return false;
+	}
+
+	Total = Stat->bDouble ? (int64)m_DoubleTotals[Stat->Column] : m_Int64Totals[Stat->Column];
+	return true;
+}
+
+bool USteamGlobalStats::GetTotalFloat(const FString& StatName, float& Total) const
+{
+	const FGlobalStat* const Stat = FindStat(StatName);
+	if (Stat == nullptr)
+	{
+		return false;
+	}
+
+	Total = Stat->bDouble ? (float)m_DoubleTotals[Stat->Column] : (float)m_Int64Totals[Stat->Column];
+	return true;
+}
+
+bool USteamGlobalStats::GetHistory(const FString& StatName, TArray<float>& History) const
+{
+	const FGlobalStat* const Stat = FindStat(StatName);
+	if (Stat == nullptr)
+	{
+		return false;
+	}
+
+	History.SetNumUninitialized(Stat->NumDays);
+	for (int32 Day = 0; Day < Stat->NumDays; Day++)
+	{
+		History[Day] = (float)GetValue(*Stat, Day);
+	}
+	return true;
+}
+
+bool USteamGlobalStats::GetDailyDeltas(const FString& StatName, TArray<float>& Deltas) const
+{
+	const FGlobalStat* const Stat = FindStat(StatName);
+	if (Stat == nullptr)
+	{
+		return false;
+	}
+
+	Deltas.SetNumUninitialized(FMath::Max(0, Stat->NumDays - 1));
+	for (int32 Day = 0; Day < Deltas.Num(); Day++)
+	{
+		Deltas[Day] = (float)(GetValue(*Stat, Day) - GetValue(*Stat, Day + 1));
+	}
+	return true;
+}
+
+bool USteamGlobalStats::GetMovingAverage(const FString& StatName, int32 WindowDays, TArray<float>& Averages) const
+{
+	const FGlobalStat* const Stat = FindStat(StatName);
+	if (Stat == nullptr)
+	{
+		return false;
+	}
+
+	WindowDays = FMath::Max(1, WindowDays);
+	const int32 NumAverages = FMath::Max(0, Stat->NumDays - WindowDays + 1);
+	Averages.SetNumUninitialized(NumAverages);
+	if (NumAverages == 0)
+	{
+		return true;
+	}
+
+	// Sliding sum, each step adds the oldest day of the new window and drops the newest day of the previous one
+	double Sum = 0.0;
+	for (int32 Day = 0; Day < WindowDays; Day++)
+	{
+		Sum += GetValue(*Stat, Day);
+	}
+
+	for (int32 Day = 0; Day < NumAverages; Day++)
+	{
+		Averages[Day] = (float)(Sum / WindowDays);
+		if (Day + WindowDays < Stat->NumDays)
+		{
+			Sum += GetValue(*Stat, Day + WindowDays) - GetValue(*Stat, Day);
+		}
+	}
+	return true;
+}
+
+TArrayView<const int64> USteamGlobalStats::GetInt64History(const FString& StatName) const
+{
+	const FGlobalStat* const Stat = FindStat(StatName);
+	if (Stat == nullptr || Stat->bDouble)
+	{
+		return TArrayView<const int64>();
+	}
+	return MakeArrayView(m_Int64History.GetData() + Stat->Column * m_HistoryDays, Stat->NumDays);
+}
+
+TArrayView<const double> USteamGlobalStats::GetDoubleHistory(const FString& StatName) const
+{
+	const FGlobalStat* const Stat = FindStat(StatName);
+	if (Stat == nullptr || !Stat->bDouble)
+	{
+		return TArrayView<const double>();
+	}
+	return MakeArrayView(m_DoubleHistory.GetData() + Stat->Column * m_HistoryDays, Stat->NumDays);
+}
+
+const USteamGlobalStats::FGlobalStat* USteamGlobalStats::FindStat(const FString& StatName) const
+{
+	const int32* const Index = m_StatIndices.Find(StatName);
+	return Index != nullptr ? &m_Stats[*Index] : nullptr;
+}
+
+double USteamGlobalStats::GetValue(const FGlobalStat& Stat, int32 Day) const
+{
+	const int32 Index = Stat.Column * m_HistoryDays + Day;
+	return Stat.bDouble ? m_DoubleHistory[Index] : (double)m_Int64History[Index];
+}
+
+void USteamGlobalStats::HandleGlobalStatsReceived(int64 GameID, ESteamResult Result)
+{
+	if ((uint32)GameID != SteamUtils()->GetAppID() || !m_bRequestPending)
+	{
+		return;
+	}
+
+	m_bRequestPending = false;
+
+	if (Result == ESteamResult::OK)
+	{
+		m_HistoryDays = m_RequestedHistoryDays;
+		m_Int64History.SetNumUninitialized(m_NumInt64Stats * m_HistoryDays);
+		m_DoubleHistory.SetNumUninitialized(m_NumDoubleStats * m_HistoryDays);
+
+		// Every history is read straight into its column, nothing is allocated per stat
+		ISteamUserStats* const UserStats = SteamUserStats();
+		for (FGlobalStat& Stat : m_Stats)
+		{
+			if (Stat.bDouble)
+			{
+				m_DoubleTotals[Stat.Column] = 0.0;
+				UserStats->GetGlobalStat(Stat.Handle.Get(), &m_DoubleTotals[Stat.Column]);
+				Stat.NumDays = m_HistoryDays > 0 ? UserStats->GetGlobalStatHistory(Stat.Handle.Get(), m_DoubleHistory.GetData() + Stat.Column * m_HistoryDays, m_HistoryDays * sizeof(double)) : 0;
+			}
+			else
+			{
+				m_Int64Totals[Stat.Column] = 0;
+				UserStats->GetGlobalStat(Stat.Handle.Get(), &m_Int64Totals[Stat.Column]);
+				Stat.NumDays = m_HistoryDays > 0 ? UserStats->GetGlobalStatHistory(Stat.Handle.Get(), m_Int64History.GetData() + Stat.Column * m_HistoryDays, m_HistoryDays * sizeof(int64)) : 0;
+			}
+		}
+	}
+
+	m_OnGlobalStatsUpdated.Broadcast(Result);
+}
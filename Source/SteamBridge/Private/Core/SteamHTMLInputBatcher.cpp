@@ -0,0 +1,102 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamHTMLInputBatcher.h"
+
+#include "Containers/Ticker.h"
+
+USteamHTMLInputBatcher::~USteamHTMLInputBatcher()
+{
+	if (m_TickHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(m_TickHandle);
+	}
+}
+
+void USteamHTMLInputBatcher::Flush(FHHTMLBrowser BrowserHandle)
+{
+	FBrowserInput* const Input = m_Browsers.Find(BrowserHandle);
+	if (Input != nullptr)
+	{
+		SendEvents(BrowserHandle, *Input);
+	}
+}
+
+void USteamHTMLInputBatcher::QueueEvent(HHTMLBrowser BrowserHandle, EInputType Type, int32 A, int32 B)
+{
+	TArray<FInputEvent>& Events = m_Browsers.FindOrAdd(BrowserHandle).Events;
+	FInputEvent* const Last = Events.Num() > 0 ? &Events.Last() : nullptr;
+	if (Last != nullptr && Last->Type == Type)
+	{
+		if (Type == EInputType::MouseMove)
+		{
+			Last->A = A;
+			Last->B = B;
+			return;
+		}
+
+		if (Type == EInputType::MouseWheel)
+		{
+			Last->A += A;
+			return;
+		}
+	}
+
+	Events.Add(FInputEvent{Type, A, B});
+
+	if (!m_TickHandle.IsValid())
+	{
+		m_TickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USteamHTMLInputBatcher::Tick));
+	}
+}
+
+void USteamHTMLInputBatcher::SendEvents(HHTMLBrowser BrowserHandle, FBrowserInput& Input)
+{
+	ISteamHTMLSurface* const HTMLSurface = SteamHTMLSurface();
+	for (const FInputEvent& Event : Input.Events)
+	{
+		switch (Event.Type)
+		{
+			case EInputType::MouseMove:
+				if (Input.LastSentPosition != FIntPoint(Event.A, Event.B))
+				{
+					HTMLSurface->MouseMove(BrowserHandle, Event.A, Event.B);
+					Input.LastSentPosition = FIntPoint(Event.A, Event.B);
+				}
+				break;
+			case EInputType::MouseWheel:
+				if (Event.A != 0)
+				{
+					HTMLSurface->MouseWheel(BrowserHandle, Event.A);
+				}
+				break;
+			case EInputType::MouseDown: HTMLSurface->MouseDown(BrowserHandle, (ISteamHTMLSurface::EHTMLMouseButton)Event.A); break;
+			case EInputType::MouseUp: HTMLSurface->MouseUp(BrowserHandle, (ISteamHTMLSurface::EHTMLMouseButton)Event.A); break;
+			case EInputType::MouseDoubleClick: HTMLSurface->MouseDoubleClick(BrowserHandle, (ISteamHTMLSurface::EHTMLMouseButton)Event.A); break;
+			case EInputType::KeyDown: HTMLSurface->KeyDown(BrowserHandle, Event.A, (ISteamHTMLSurface::EHTMLKeyModifiers)Event.B); break;
+			case EInputType::KeyUp: HTMLSurface->KeyUp(BrowserHandle, Event.A, (ISteamHTMLSurface::EHTMLKeyModifiers)Event.B); break;
+			case EInputType::KeyChar: HTMLSurface->KeyChar(BrowserHandle, Event.A, (ISteamHTMLSurface::EHTMLKeyModifiers)Event.B); break;
+			default: break;
+		}
+	}
+
+	// Reset keeps the allocation, a browser that gets input every frame doesn't reallocate its queue
+	Input.Events.Reset();
+}
+
+bool USteamHTMLInputBatcher::Tick(float DeltaTime)
+{
+	bool bHadInput = false;
+	for (TPair<HHTMLBrowser, FBrowserInput>& Entry : m_Browsers)
+	{
+		bHadInput |= Entry.Value.Events.Num() > 0;
+		SendEvents(Entry.Key, Entry.Value);
+	}
+
+	// Keep ticking while input keeps coming, stop after the first frame without any
+	if (!bHadInput)
+	{
+		m_TickHandle.Reset();
+		return false;
+	}
+	return true;
+}
@@ -120,7 +120,7 @@ void USteamHTMLSurface::OnHTMLLinkAtPosition(HTML_LinkAtPosition_t* pParam)
 
 void USteamHTMLSurface::OnHTMLNeedsPaint(HTML_NeedsPaint_t* pParam)
 {
-	m_OnHTMLNeedsPaint.Broadcast(pParam->unBrowserHandle, UTF8_TO_TCHAR(pParam->pBGRA), {(int32)pParam->unTall, (int32)pParam->unWide}, {(int32)pParam->unUpdateX, (int32)pParam->unUpdateY}, {(int32)pParam->unUpdateTall, (int32)pParam->unUpdateWide},
+	m_OnHTMLNeedsPaint.Broadcast(pParam->unBrowserHandle, {(int32)pParam->unWide, (int32)pParam->unTall}, {(int32)pParam->unUpdateX, (int32)pParam->unUpdateY}, {(int32)pParam->unUpdateWide, (int32)pParam->unUpdateTall},
 		{(int32)pParam->unScrollX, (int32)pParam->unScrollY}, pParam->flPageScale, pParam->unPageSerial);
 }
 
@@ -0,0 +1,119 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamHTMLSurfaceComponent.h"
+
+namespace
+{
+	constexpr int32 BytesPerPixel = 4;
+}  // namespace
+
+USteamHTMLSurfaceComponent::FPaintBufferPool::~FPaintBufferPool()
+{
+	FPaintBuffer* Buffer = nullptr;
+	while (FreeBuffers.Dequeue(Buffer))
+	{
+		delete Buffer;
+	}
+}
+
+USteamHTMLSurfaceComponent::USteamHTMLSurfaceComponent() :
+	m_Texture(nullptr), m_BrowserHandle(INVALID_HTMLBROWSER), m_PaintBuffers(MakeShared<FPaintBufferPool, ESPMode::ThreadSafe>())
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void USteamHTMLSurfaceComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	OnHTMLNeedsPaintCallback.Register(this, &USteamHTMLSurfaceComponent::OnHTMLNeedsPaint);
+}
+
+void USteamHTMLSurfaceComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	OnHTMLNeedsPaintCallback.Unregister();
+	Super::EndPlay(EndPlayReason);
+}
+
+void USteamHTMLSurfaceComponent::SetBrowser(FHHTMLBrowser BrowserHandle)
+{
+	m_BrowserHandle = BrowserHandle;
+
+	// The old texture holds pixels of the previous browser, make the next paint upload everything
+	m_Texture = nullptr;
+}
+
+void USteamHTMLSurfaceComponent::RecreateTexture(int32 Width, int32 Height)
+{
+	m_Texture = UTexture2D::CreateTransient(Width, Height, PF_B8G8R8A8);
+	if (m_Texture != nullptr)
+	{
+		m_Texture->SRGB = true;
+		m_Texture->UpdateResource();
+		m_OnTextureCreated.Broadcast(m_Texture);
+	}
+}
+
+void USteamHTMLSurfaceComponent::UploadRegion(const uint8* BGRA, int32 Pitch, int32 X, int32 Y, int32 Width, int32 Height)
+{
+	// Steam's buffer is only valid during the callback and the upload runs on the render thread later, so the dirty rectangle is copied.
+	// Buffers come back from the render thread and are reused, so after the first few paints nothing is allocated anymore.
+	FPaintBuffer* Buffer = nullptr;
+	if (!m_PaintBuffers->FreeBuffers.Dequeue(Buffer))
+	{
+		Buffer = new FPaintBuffer();
+	}
+
+	const int32 RowSize = Width * BytesPerPixel;
+	Buffer->Region = FUpdateTextureRegion2D(X, Y, 0, 0, Width, Height);
+	Buffer->Pixels.SetNumUninitialized(RowSize * Height, false);
+
+	const uint8* Source = BGRA + Y * Pitch + X * BytesPerPixel;
+	if (RowSize == Pitch)
+	{
+		FMemory::Memcpy(Buffer->Pixels.GetData(), Source, RowSize * Height);
+	}
+	else
+	{
+		for (int32 Row = 0; Row < Height; Row++)
+		{
+			FMemory::Memcpy(Buffer->Pixels.GetData() + Row * RowSize, Source + Row * Pitch, RowSize);
+		}
+	}
+
+	TSharedRef<FPaintBufferPool, ESPMode::ThreadSafe> Pool = m_PaintBuffers;
+	m_Texture->UpdateTextureRegions(0, 1, &Buffer->Region, RowSize, BytesPerPixel, Buffer->Pixels.GetData(), [Pool, Buffer](uint8* SrcData, const FUpdateTextureRegion2D* Regions) {
+		Pool->FreeBuffers.Enqueue(Buffer);
+	});
+}
+
+void USteamHTMLSurfaceComponent::OnHTMLNeedsPaint(HTML_NeedsPaint_t* pParam)
+{
+	if (pParam->unBrowserHandle != m_BrowserHandle || pParam->pBGRA == nullptr || pParam->unWide == 0 || pParam->unTall == 0)
+	{
+		return;
+	}
+
+	const int32 Width = pParam->unWide;
+	const int32 Height = pParam->unTall;
+	const uint8* const BGRA = (const uint8*)pParam->pBGRA;
+
+	// A new texture starts out empty so it needs the whole page, not just what changed
+	if (m_Texture == nullptr || m_Texture->GetSizeX() != Width || m_Texture->GetSizeY() != Height)
+	{
+		RecreateTexture(Width, Height);
+		if (m_Texture != nullptr)
+		{
+			UploadRegion(BGRA, Width * BytesPerPixel, 0, 0, Width, Height);
+		}
+		return;
+	}
+
+	const int32 X = FMath::Min<int32>(pParam->unUpdateX, Width);
+	const int32 Y = FMath::Min<int32>(pParam->unUpdateY, Height);
+	const int32 UpdateWidth = FMath::Min<int32>(pParam->unUpdateWide, Width - X);
+	const int32 UpdateHeight = FMath::Min<int32>(pParam->unUpdateTall, Height - Y);
+	if (UpdateWidth > 0 && UpdateHeight > 0)
+	{
+		UploadRegion(BGRA, Width * BytesPerPixel, X, Y, UpdateWidth, UpdateHeight);
+	}
+}
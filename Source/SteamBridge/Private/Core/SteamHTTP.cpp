@@ -4,6 +4,7 @@
 
 #include "Core/SteamHTTP.h"
 
+#include "Core/SteamHTTPRequest.h"
 #include "SteamBridgeUtils.h"
 
 USteamHTTP::USteamHTTP()
@@ -20,6 +21,59 @@ USteamHTTP::~USteamHTTP()
 	OnHTTPRequestHeadersReceivedCallback.Unregister();
 }
 
+bool USteamHTTP::GetHTTPResponseBodyData(FHTTPRequestHandle RequestHandle, TArray<uint8>& BodyDataBuffer) const
+{
+	uint32 BodySize = 0;
+	if (!SteamHTTP()->GetHTTPResponseBodySize(RequestHandle, &BodySize))
+	{
+		BodyDataBuffer.Reset();
+		return false;
+	}
+
+	BodyDataBuffer.SetNumUninitialized(BodySize);
+	const bool bResult = BodySize == 0 || SteamHTTP()->GetHTTPResponseBodyData(RequestHandle, BodyDataBuffer.GetData(), BodySize);
+	if (!bResult)
+	{
+		BodyDataBuffer.Reset();
+	}
+	return bResult;
+}
+
+bool USteamHTTP::GetHTTPResponseHeaderValue(FHTTPRequestHandle RequestHandle, const FString& HeaderName, FString& HeaderValue) const
+{
+	FTCHARToUTF8 Name(*HeaderName);
+	uint32 ValueSize = 0;
+	if (!SteamHTTP()->GetHTTPResponseHeaderSize(RequestHandle, Name.Get(), &ValueSize))
+	{
+		HeaderValue.Reset();
+		return false;
+	}
+
+	// The size includes the null terminator
+	TArray<uint8, TInlineAllocator<256>> Buffer;
+	Buffer.SetNumZeroed(ValueSize + 1);
+	if (!SteamHTTP()->GetHTTPResponseHeaderValue(RequestHandle, Name.Get(), Buffer.GetData(), ValueSize))
+	{
+		HeaderValue.Reset();
+		return false;
+	}
+
+	USteamBridgeUtils::ConvertUTF8ToString((const char*)Buffer.GetData(), ValueSize, HeaderValue);
+	return true;
+}
+
+bool USteamHTTP::GetHTTPStreamingResponseBodyData(FHTTPRequestHandle RequestHandle, int32 Offset, int32 BytesReceived, TArray<uint8>& BodyDataBuffer) const
+{
+	// Don't shrink so a buffer reused for every chunk of a stream is only allocated once
+	BodyDataBuffer.SetNumUninitialized(FMath::Max(0, BytesReceived), false);
+	const bool bResult = SteamHTTP()->GetHTTPStreamingResponseBodyData(RequestHandle, Offset, BodyDataBuffer.GetData(), BodyDataBuffer.Num());
+	if (!bResult)
+	{
+		BodyDataBuffer.Reset();
+	}
+	return bResult;
+}
+
 void USteamHTTP::OnHTTPRequestCompleted(HTTPRequestCompleted_t* pParam)
 {
 	m_OnHTTPRequestCompleted.Broadcast(pParam->m_hRequest, pParam->m_ulContextValue, pParam->m_bRequestSuccessful, (ESteamHTTPStatus::Type)pParam->m_eStatusCode, pParam->m_unBodySize);
@@ -27,6 +81,14 @@ void USteamHTTP::OnHTTPRequestCompleted(HTTPRequestCompleted_t* pParam)
 
 void USteamHTTP::OnHTTPRequestDataReceived(HTTPRequestDataReceived_t* pParam)
 {
+	const TSharedRef<FSteamHTTPRequest>* const Request = m_PendingRequests.FindByPredicate([pParam](const TSharedRef<FSteamHTTPRequest>& Pending) { return Pending->GetHandle() == pParam->m_hRequest; });
+	if (Request != nullptr)
+	{
+		// The request may cancel itself and drop out of m_PendingRequests
+		const TSharedRef<FSteamHTTPRequest> StreamingRequest = *Request;
+		StreamingRequest->OnDataReceived(pParam->m_cOffset, pParam->m_cBytesReceived);
+	}
+
 	m_OnHTTPRequestDataReceived.Broadcast(pParam->m_hRequest, pParam->m_ulContextValue, pParam->m_cOffset, pParam->m_cBytesReceived);
 }
 
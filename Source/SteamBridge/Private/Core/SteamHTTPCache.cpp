@@ -0,0 +1,303 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamHTTPCache.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "SteamBridgeSettings.h"
+
+namespace
+{
+	constexpr uint32 IndexMagic = 0x53424843;  // SBHC
+	constexpr int32 IndexVersion = 2;
+
+	const TCHAR* const ETagHeader = TEXT("ETag");
+	const TCHAR* const LastModifiedHeader = TEXT("Last-Modified");
+
+	// Separates the URL from the hash of the request headers in a key, it can't be part of a URL
+	const TCHAR* const KeySeparator = TEXT(" ");
+}  // namespace
+
+USteamHTTPCache::USteamHTTPCache() :
+	m_TotalBytes(0), m_UseCounter(0), m_bIndexLoaded(false)
+{
+}
+
+TFuture<FSteamHTTPResponse> USteamHTTPCache::Get(const FString& URL, const TMap<FString, FString>& Headers)
+{
+	LoadIndex();
+
+	TSharedRef<TPromise<FSteamHTTPResponse>> Promise = MakeShared<TPromise<FSteamHTTPResponse>>();
+	TFuture<FSteamHTTPResponse> Future = Promise->GetFuture();
+	const FString Key = MakeKey(URL, Headers);
+	Fetch(URL, Key, Headers, m_Entries.Contains(Key), Promise);
+	return Future;
+}
+
+void USteamHTTPCache::Invalidate(const FString& URL)
+{
+	LoadIndex();
+
+	const FString KeyPrefix = URL + KeySeparator;
+	TArray<FString> Keys;
+	for (const TPair<FString, FEntry>& Entry : m_Entries)
+	{
+		if (Entry.Key == URL || Entry.Key.StartsWith(KeyPrefix, ESearchCase::CaseSensitive))
+		{
+			Keys.Add(Entry.Key);
+		}
+	}
+
+	for (const FString& Key : Keys)
+	{
+		RemoveEntry(Key);
+	}
+
+	if (Keys.Num() > 0)
+	{
+		SaveIndex();
+	}
+}
+
+void USteamHTTPCache::Clear()
+{
+	IFileManager::Get().DeleteDirectory(*GetCacheDir(), false, true);
+	m_Entries.Empty();
+	m_TotalBytes = 0;
+	m_bIndexLoaded = true;
+}
+
+void USteamHTTPCache::Fetch(const FString& URL, const FString& Key, const TMap<FString, FString>& Headers, bool bConditional, const TSharedRef<TPromise<FSteamHTTPResponse>>& Promise)
+{
+	TSharedRef<FSteamHTTPRequest> Request = FSteamHTTPRequest::Create(ESteamHTTPMethod::GET, URL);
+	for (const TPair<FString, FString>& Header : Headers)
+	{
+		Request->SetHeader(Header.Key, Header.Value);
+	}
+
+	if (bConditional)
+	{
+		const FEntry& Entry = m_Entries[Key];
+		if (!Entry.ETag.IsEmpty())
+		{
+			Request->SetHeader(TEXT("If-None-Match"), Entry.ETag);
+		}
+		if (!Entry.LastModified.IsEmpty())
+		{
+			Request->SetHeader(TEXT("If-Modified-Since"), Entry.LastModified);
+		}
+	}
+
+	Request->CaptureResponseHeader(ETagHeader).CaptureResponseHeader(LastModifiedHeader);
+	Request->Send().Next([this, URL, Key, Headers, bConditional, Promise](const FSteamHTTPResponse& Response) {
+		HandleResponse(URL, Key, Headers, bConditional, Promise, FSteamHTTPResponse(Response));
+	});
+}
+
+void USteamHTTPCache::HandleResponse(const FString& URL, const FString& Key, const TMap<FString, FString>& Headers, bool bConditional, const TSharedRef<TPromise<FSteamHTTPResponse>>& Promise, FSteamHTTPResponse&& Response)
+{
+	const bool bNotModified = Response.bSuccessful && Response.StatusCode == ESteamHTTPStatus::e_304NotModified;
+	if (bNotModified || (!Response.bSuccessful && m_Entries.Contains(Key)))
+	{
+		if (ReadCachedBody(Key, Response.Body))
+		{
+			Response.bSuccessful = true;
+			Response.bFromCache = true;
+			Response.StatusCode = ESteamHTTPStatus::e_200OK;
+			Promise->SetValue(MoveTemp(Response));
+			return;
+		}
+
+		// The body went missing, drop the entry and ask for the whole response once more
+		RemoveEntry(Key);
+		SaveIndex();
+		if (bNotModified && bConditional)
+		{
+			Fetch(URL, Key, Headers, false, Promise);
+			return;
+		}
+	}
+
+	if (Response.bSuccessful && Response.StatusCode == ESteamHTTPStatus::e_200OK)
+	{
+		if (Response.Headers.Contains(ETagHeader) || Response.Headers.Contains(LastModifiedHeader))
+		{
+			Store(Key, Response);
+		}
+		else if (m_Entries.Contains(Key))
+		{
+			// The response can't be revalidated anymore, the stored one is out of date
+			RemoveEntry(Key);
+			SaveIndex();
+		}
+	}
+
+	Promise->SetValue(MoveTemp(Response));
+}
+
+bool USteamHTTPCache::ReadCachedBody(const FString& Key, TArray<uint8>& Body)
+{
+	FEntry* const Entry = m_Entries.Find(Key);
+	if (Entry == nullptr || !FFileHelper::LoadFileToArray(Body, *GetBodyPath(Key), FILEREAD_Silent) || Body.Num() != Entry->Size)
+	{
+		Body.Reset();
+		return false;
+	}
+
+	Entry->LastUsed = ++m_UseCounter;
+	SaveIndex();
+	return true;
+}
+
+void USteamHTTPCache::Store(const FString& Key, const FSteamHTTPResponse& Response)
+{
+	const int64 MaxBytes = GetDefault<USteamBridgeSettings>()->HTTPCacheMaxBytes;
+	if (m_Entries.Contains(Key))
+	{
+		RemoveEntry(Key);
+	}
+
+	if (Response.Body.Num() > MaxBytes || !FFileHelper::SaveArrayToFile(Response.Body, *GetBodyPath(Key)))
+	{
+		SaveIndex();
+		return;
+	}
+
+	EvictToFit(MaxBytes - Response.Body.Num());
+
+	FEntry& Entry = m_Entries.Add(Key);
+	Entry.ETag = Response.Headers.FindRef(ETagHeader);
+	Entry.LastModified = Response.Headers.FindRef(LastModifiedHeader);
+	Entry.Size = Response.Body.Num();
+	Entry.LastUsed = ++m_UseCounter;
+	m_TotalBytes += Entry.Size;
+	SaveIndex();
+}
+
+void USteamHTTPCache::RemoveEntry(const FString& Key)
+{
+	FEntry Entry;
+	if (m_Entries.RemoveAndCopyValue(Key, Entry))
+	{
+		m_TotalBytes -= Entry.Size;
+		IFileManager::Get().Delete(*GetBodyPath(Key), false, false, true);
+	}
+}
+
+void USteamHTTPCache::EvictToFit(int64 MaxBytes)
+{
+	while (m_TotalBytes > MaxBytes && m_Entries.Num() > 0)
+	{
+		const FString* LeastRecent = nullptr;
+		uint64 LeastRecentUse = MAX_uint64;
+		for (const TPair<FString, FEntry>& Entry : m_Entries)
+		{
+			if (Entry.Value.LastUsed < LeastRecentUse)
+			{
+				LeastRecentUse = Entry.Value.LastUsed;
+				LeastRecent = &Entry.Key;
+			}
+		}
+
+		RemoveEntry(FString(*LeastRecent));
+	}
+}
+
+void USteamHTTPCache::LoadIndex()
+{
+	if (m_bIndexLoaded)
+	{
+		return;
+	}
+	m_bIndexLoaded = true;
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *(GetCacheDir() / TEXT("Index.bin")), FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Ar(Data);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	Ar << Magic << Version;
+	if (Magic != IndexMagic || Version != IndexVersion)
+	{
+		// The bodies were stored under keys this version doesn't use anymore
+		IFileManager::Get().DeleteDirectory(*GetCacheDir(), false, true);
+		return;
+	}
+
+	Ar << m_Entries;
+	if (Ar.IsError())
+	{
+		m_Entries.Empty();
+		return;
+	}
+
+	for (const TPair<FString, FEntry>& Entry : m_Entries)
+	{
+		m_TotalBytes += Entry.Value.Size;
+		m_UseCounter = FMath::Max(m_UseCounter, Entry.Value.LastUsed);
+	}
+
+	// The limit may have been lowered since the index was saved
+	const int64 MaxBytes = GetDefault<USteamBridgeSettings>()->HTTPCacheMaxBytes;
+	if (m_TotalBytes > MaxBytes)
+	{
+		EvictToFit(MaxBytes);
+		SaveIndex();
+	}
+}
+
+void USteamHTTPCache::SaveIndex()
+{
+	TArray<uint8> Data;
+	FMemoryWriter Ar(Data);
+
+	uint32 Magic = IndexMagic;
+	int32 Version = IndexVersion;
+	Ar << Magic << Version;
+	Ar << m_Entries;
+
+	FFileHelper::SaveArrayToFile(Data, *(GetCacheDir() / TEXT("Index.bin")));
+}
+
+FString USteamHTTPCache::GetCacheDir()
+{
+	return FPaths::ProjectSavedDir() / TEXT("SteamBridge/HTTPCache");
+}
+
+FString USteamHTTPCache::MakeKey(const FString& URL, const TMap<FString, FString>& Headers)
+{
+	if (Headers.Num() == 0)
+	{
+		return URL;
+	}
+
+	// Responses depend on headers like Authorization or Accept. They're only kept as a hash so credentials never end up in the index.
+	TArray<FString> Lines;
+	Lines.Reserve(Headers.Num());
+	for (const TPair<FString, FString>& Header : Headers)
+	{
+		Lines.Add(Header.Key.ToLower() + TEXT(":") + Header.Value);
+	}
+	Lines.Sort();
+
+	FTCHARToUTF8 UTF8Headers(*FString::Join(Lines, TEXT("\n")));
+	FSHAHash Hash;
+	FSHA1::HashBuffer(UTF8Headers.Get(), UTF8Headers.Length(), Hash.Hash);
+	return URL + KeySeparator + Hash.ToString();
+}
+
+FString USteamHTTPCache::GetBodyPath(const FString& Key)
+{
+	FTCHARToUTF8 UTF8Key(*Key);
+	FSHAHash Hash;
+	FSHA1::HashBuffer(UTF8Key.Get(), UTF8Key.Length(), Hash.Hash);
+	return GetCacheDir() / Hash.ToString() + TEXT(".bin");
+}
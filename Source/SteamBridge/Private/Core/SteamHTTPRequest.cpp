@@ -0,0 +1,297 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamHTTPRequest.h"
+
+#include "Async/Async.h"
+#include "Core/SteamHTTP.h"
+#include "HAL/FileManager.h"
+
+FSteamHTTPRequest::FSteamHTTPRequest() :
+	m_Handle(INVALID_HTTPREQUEST_HANDLE), m_StreamOffset(0), m_bInFlight(false), m_bInSink(false), m_bCancelRequested(false)
+{
+}
+
+TSharedRef<FSteamHTTPRequest> FSteamHTTPRequest::Create(ESteamHTTPMethod Method, const FString& AbsoluteURL)
+{
+	TSharedRef<FSteamHTTPRequest> Request = MakeShareable(new FSteamHTTPRequest());
+	Request->m_Handle = SteamHTTP()->CreateHTTPRequest((EHTTPMethod)Method, TCHAR_TO_UTF8(*AbsoluteURL));
+	return Request;
+}
+
+FSteamHTTPRequest::~FSteamHTTPRequest()
+{
+	if (m_Handle != INVALID_HTTPREQUEST_HANDLE)
+	{
+		SteamHTTP()->ReleaseHTTPRequest(m_Handle);
+	}
+}
+
+FSteamHTTPRequest& FSteamHTTPRequest::SetHeader(const FString& Name, const FString& Value)
+{
+	SteamHTTP()->SetHTTPRequestHeaderValue(m_Handle, TCHAR_TO_UTF8(*Name), TCHAR_TO_UTF8(*Value));
+	return *this;
+}
+
+FSteamHTTPRequest& FSteamHTTPRequest::SetParameter(const FString& Name, const FString& Value)
+{
+	SteamHTTP()->SetHTTPRequestGetOrPostParameter(m_Handle, TCHAR_TO_UTF8(*Name), TCHAR_TO_UTF8(*Value));
+	return *this;
+}
+
+FSteamHTTPRequest& FSteamHTTPRequest::SetBody(const FString& ContentType, TArrayView<const uint8> Body)
+{
+	SteamHTTP()->SetHTTPRequestRawPostBody(m_Handle, TCHAR_TO_UTF8(*ContentType), const_cast<uint8*>(Body.GetData()), Body.Num());
+	return *this;
+}
+
+FSteamHTTPRequest& FSteamHTTPRequest::SetTimeout(int32 Milliseconds)
+{
+	SteamHTTP()->SetHTTPRequestAbsoluteTimeoutMS(m_Handle, Milliseconds);
+	return *this;
+}
+
+FSteamHTTPRequest& FSteamHTTPRequest::SetCookieContainer(HTTPCookieContainerHandle CookieContainer)
+{
+	SteamHTTP()->SetHTTPRequestCookieContainer(m_Handle, CookieContainer);
+	return *this;
+}
+
+FSteamHTTPRequest& FSteamHTTPRequest::CaptureResponseHeader(const FString& Name)
+{
+	m_CapturedHeaders.AddUnique(Name);
+	return *this;
+}
+
+TFuture<FSteamHTTPResponse> FSteamHTTPRequest::Send(TArray<uint8>&& BodyBuffer, EPriority Priority)
+{
+	// A request can only be sent once, its handle is released when it finished
+	if (m_bInFlight || m_Handle == INVALID_HTTPREQUEST_HANDLE)
+	{
+		TPromise<FSteamHTTPResponse> Promise;
+		Promise.SetValue(FSteamHTTPResponse());
+		return Promise.GetFuture();
+	}
+
+	m_BodyBuffer = MoveTemp(BodyBuffer);
+	TFuture<FSteamHTTPResponse> Future = m_Promise.Emplace().GetFuture();
+	if (!SendInternal(false, Priority))
+	{
+		FSteamHTTPResponse Response;
+		Response.Body = MoveTemp(m_BodyBuffer);
+		Response.Body.Reset();
+		Finish(MoveTemp(Response));
+	}
+	return Future;
+}
+
+TFuture<FSteamHTTPResponse> FSteamHTTPRequest::SendAndStream(FSteamHTTPStreamSink&& Sink, EPriority Priority)
+{
+	if (m_bInFlight || m_Handle == INVALID_HTTPREQUEST_HANDLE)
+	{
+		TPromise<FSteamHTTPResponse> Promise;
+		Promise.SetValue(FSteamHTTPResponse());
+		return Promise.GetFuture();
+	}
+
+	m_StreamSink = MoveTemp(Sink);
+	m_StreamOffset = 0;
+	TFuture<FSteamHTTPResponse> Future = m_Promise.Emplace().GetFuture();
+	if (!SendInternal(true, Priority))
+	{
+		Finish(FSteamHTTPResponse());
+	}
+	return Future;
+}
+
+bool FSteamHTTPRequest::SendInternal(bool bStream, EPriority Priority)
+{
+	SteamAPICall_t Call = k_uAPICallInvalid;
+	const bool bSent = bStream ? SteamHTTP()->SendHTTPRequestAndStreamResponse(m_Handle, &Call) : SteamHTTP()->SendHTTPRequest(m_Handle, &Call);
+	if (!bSent)
+	{
+		return false;
+	}
+
+	m_bInFlight = true;
+	m_CallResult.Set(Call, this, &FSteamHTTPRequest::OnRequestCompleted);
+	SetPriority(Priority);
+	USteamHTTP::GetSteamHTTP()->m_PendingRequests.Add(AsShared());
+	return true;
+}
+
+bool FSteamHTTPRequest::SetPriority(EPriority Priority)
+{
+	switch (Priority)
+	{
+		case EPriority::High: return SteamHTTP()->PrioritizeHTTPRequest(m_Handle);
+		case EPriority::Low: return SteamHTTP()->DeferHTTPRequest(m_Handle);
+		default: return true;
+	}
+}
+
+void FSteamHTTPRequest::Cancel()
+{
+	if (!m_bInFlight)
+	{
+		return;
+	}
+
+	if (m_bInSink)
+	{
+		m_bCancelRequested = true;
+		return;
+	}
+
+	m_CallResult.Cancel();
+	m_bInFlight = false;
+
+	FSteamHTTPResponse Response;
+	Response.Body = MoveTemp(m_BodyBuffer);
+	Response.Body.Reset();
+
+	// Keep the request alive until Finish returned, the pending list may hold the last reference
+	TSharedRef<FSteamHTTPRequest> Self = AsShared();
+	USteamHTTP::GetSteamHTTP()->m_PendingRequests.Remove(Self);
+	Finish(MoveTemp(Response));
+}
+
+void FSteamHTTPRequest::OnDataReceived(uint32 Offset, uint32 BytesReceived)
+{
+	if (!m_bInFlight || !m_StreamSink)
+	{
+		return;
+	}
+
+	// Chunks arrive in order, a gap means one was lost and the body can't be reassembled
+	if (Offset != m_StreamOffset || !USteamHTTP::GetSteamHTTP()->GetHTTPStreamingResponseBodyData(m_Handle, Offset, BytesReceived, m_BodyBuffer))
+	{
+		Cancel();
+		return;
+	}
+
+	m_StreamOffset += BytesReceived;
+	m_bInSink = true;
+	const bool bContinue = m_StreamSink(m_BodyBuffer);
+	m_bInSink = false;
+
+	if (!bContinue || m_bCancelRequested)
+	{
+		m_bCancelRequested = false;
+		Cancel();
+	}
+}
+
+void FSteamHTTPRequest::OnRequestCompleted(HTTPRequestCompleted_t* pParam, bool bIOFailure)
+{
+	USteamHTTP* const HTTP = USteamHTTP::GetSteamHTTP();
+	HTTP->m_FinishedRequests.Reset();
+	m_bInFlight = false;
+
+	FSteamHTTPResponse Response;
+	Response.bSuccessful = !bIOFailure && pParam->m_bRequestSuccessful;
+	Response.Body = MoveTemp(m_BodyBuffer);
+	Response.Body.Reset();
+
+	if (Response.bSuccessful)
+	{
+		Response.StatusCode = (ESteamHTTPStatus::Type)pParam->m_eStatusCode;
+
+		if (m_StreamSink)
+		{
+			// The body was cut off if fewer bytes were streamed than the server announced, chunked responses announce nothing
+			Response.bSuccessful = pParam->m_unBodySize == 0 || m_StreamOffset == pParam->m_unBodySize;
+			Response.Body.Empty();
+		}
+		else
+		{
+			// Read straight into the caller's buffer, it's only reallocated if it's too small
+			Response.Body.SetNumUninitialized(pParam->m_unBodySize, false);
+			if (pParam->m_unBodySize > 0 && !SteamHTTP()->GetHTTPResponseBodyData(m_Handle, Response.Body.GetData(), pParam->m_unBodySize))
+			{
+				Response.bSuccessful = false;
+				Response.Body.Reset();
+			}
+		}
+
+		for (const FString& HeaderName : m_CapturedHeaders)
+		{
+			FString Value;
+			if (HTTP->GetHTTPResponseHeaderValue(m_Handle, HeaderName, Value))
+			{
+				Response.Headers.Add(HeaderName, MoveTemp(Value));
+			}
+		}
+	}
+	else if (!bIOFailure)
+	{
+		SteamHTTP()->GetHTTPRequestWasTimedOut(m_Handle, &Response.bTimedOut);
+	}
+
+	const int32 Index = HTTP->m_PendingRequests.IndexOfByPredicate([this](const TSharedRef<FSteamHTTPRequest>& Pending) { return &Pending.Get() == this; });
+	if (Index != INDEX_NONE)
+	{
+		HTTP->m_FinishedRequests.Add(HTTP->m_PendingRequests[Index]);
+		HTTP->m_PendingRequests.RemoveAtSwap(Index, 1, false);
+	}
+
+	Finish(MoveTemp(Response));
+}
+
+void FSteamHTTPRequest::Finish(FSteamHTTPResponse&& Response)
+{
+	if (m_Handle != INVALID_HTTPREQUEST_HANDLE)
+	{
+		SteamHTTP()->ReleaseHTTPRequest(m_Handle);
+		m_Handle = INVALID_HTTPREQUEST_HANDLE;
+	}
+
+	// Destroy the sink first so e.g. a file writer closed its file by the time the future is set
+	m_StreamSink.Reset();
+	m_Promise->SetValue(MoveTemp(Response));
+}
+
+FSteamHTTPStreamSink FSteamHTTPFileWriter::MakeSink(const FString& FilePath)
+{
+	TSharedRef<FSteamHTTPFileWriter> Writer = MakeShared<FSteamHTTPFileWriter>(FilePath);
+	return [Writer](TArrayView<const uint8> Data) { return Writer->Write(Data); };
+}
+
+FSteamHTTPFileWriter::FSteamHTTPFileWriter(const FString& FilePath) :
+	m_File(IFileManager::Get().CreateFileWriter(*FilePath)), m_bError(false)
+{
+}
+
+FSteamHTTPFileWriter::~FSteamHTTPFileWriter()
+{
+	if (m_Write.IsValid())
+	{
+		m_Write.Wait();
+	}
+
+	if (m_File.IsValid())
+	{
+		m_File->Close();
+	}
+}
+
+bool FSteamHTTPFileWriter::Write(TArrayView<const uint8> Data)
+{
+	if (m_Write.IsValid())
+	{
+		m_Write.Wait();
+	}
+
+	if (!m_File.IsValid() || m_bError)
+	{
+		return false;
+	}
+
+	// Reset keeps the allocation so the copy only allocates when a chunk is larger than every one before it
+	m_WritingChunk.Reset();
+	m_WritingChunk.Append(Data.GetData(), Data.Num());
+	m_Write = Async(EAsyncExecution::ThreadPool, [this]() {
+		m_File->Serialize(m_WritingChunk.GetData(), m_WritingChunk.Num());
+		m_bError = m_File->IsError();
+	});
+	return true;
+}
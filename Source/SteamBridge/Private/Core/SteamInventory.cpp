@@ -39,39 +39,44 @@ bool USteamInventory::AddPromoItems(FSteamInventoryResult& ResultHandle, const T
 
 bool USteamInventory::ExchangeItems(FSteamInventoryResult& ResultHandle, const TMap<FSteamItemDef, int32>& ItemsGenerated, const TMap<FSteamItemInstanceID, int32>& ItemsDestroyed) const
 {
-	// NOTE: I converted this method to support a TMap instead of 4 arrays so I'm not entirely sure if it works lemme know - trdwll
 	if (ItemsGenerated.Num() < 1 || ItemsDestroyed.Num() < 1) return false;
 
 	TArray<SteamItemDef_t> TmpItemsGenerated;
-	TArray<SteamItemInstanceID_t> TmpItemsDestroyed;
 	TArray<uint32> TmpItemsGeneratedQuantity;
-	TmpItemsGeneratedQuantity.Init(1, TmpItemsGenerated.Num());
-	TArray<uint32> TmpItemsDestroyedQuantity;
-	TmpItemsDestroyedQuantity.Init(1, TmpItemsDestroyed.Num());
-
+	TmpItemsGenerated.Reserve(ItemsGenerated.Num());
+	TmpItemsGeneratedQuantity.Reserve(ItemsGenerated.Num());
 	for (const auto& pair : ItemsGenerated)
 	{
 		TmpItemsGenerated.Add(pair.Key);
+		TmpItemsGeneratedQuantity.Add(pair.Value);
 	}
+
+	TArray<SteamItemInstanceID_t> TmpItemsDestroyed;
+	TArray<uint32> TmpItemsDestroyedQuantity;
+	TmpItemsDestroyed.Reserve(ItemsDestroyed.Num());
+	TmpItemsDestroyedQuantity.Reserve(ItemsDestroyed.Num());
 	for (const auto& pair : ItemsDestroyed)
 	{
 		TmpItemsDestroyed.Add(pair.Key);
+		TmpItemsDestroyedQuantity.Add(pair.Value);
 	}
-	return SteamInventory()->ExchangeItems(&ResultHandle.Value, TmpItemsGenerated.GetData(), TmpItemsGeneratedQuantity.GetData(), ItemsGenerated.Num(), TmpItemsDestroyed.GetData(), TmpItemsDestroyedQuantity.GetData(), ItemsDestroyed.Num());
+
+	return SteamInventory()->ExchangeItems(&ResultHandle.Value, TmpItemsGenerated.GetData(), TmpItemsGeneratedQuantity.GetData(), TmpItemsGenerated.Num(), TmpItemsDestroyed.GetData(), TmpItemsDestroyedQuantity.GetData(), TmpItemsDestroyed.Num());
 }
 
 bool USteamInventory::GenerateItems(FSteamInventoryResult& ResultHandle, const TMap<FSteamItemDef, int32>& Items) const
 {
-	// NOTE: I converted this method to support a TMap instead of 2 arrays so I'm not entirely sure if it works lemme know - trdwll
-
 	TArray<SteamItemDef_t> TmpItems;
-
+	TArray<uint32> TmpQuantities;
+	TmpItems.Reserve(Items.Num());
+	TmpQuantities.Reserve(Items.Num());
 	for (const auto& pair : Items)
 	{
 		TmpItems.Add(pair.Key);
+		TmpQuantities.Add(pair.Value);
 	}
 
-	return SteamInventory()->GenerateItems(&ResultHandle.Value, TmpItems.GetData(), (uint32*)TmpItems.GetData(), TmpItems.Num());
+	return SteamInventory()->GenerateItems(&ResultHandle.Value, TmpItems.GetData(), TmpQuantities.GetData(), TmpItems.Num());
 }
 
 bool USteamInventory::GetEligiblePromoItemDefinitionIDs(FSteamID SteamID, TArray<FSteamItemDef>& Items) const
@@ -95,18 +100,14 @@ bool USteamInventory::GetEligiblePromoItemDefinitionIDs(FSteamID SteamID, TArray
 
 bool USteamInventory::GetItemDefinitionIDs(TArray<FSteamItemDef>& Items) const
 {
+	static_assert(sizeof(FSteamItemDef) == sizeof(SteamItemDef_t), "FSteamItemDef must be layout compatible with SteamItemDef_t");
+
 	uint32 TmpCount = 0;
 	if (SteamInventory()->GetItemDefinitionIDs(nullptr, &TmpCount))
 	{
-		TArray<SteamItemDef_t> TmpArray;
-		TmpArray.SetNum(TmpCount);
-		bool result = SteamInventory()->GetItemDefinitionIDs(TmpArray.GetData(), &TmpCount);
-
-		for (int32 i = 0; i < (int32)TmpCount; i++)
-		{
-			Items.Add(TmpArray[i]);
-		}
-
+		Items.SetNumUninitialized(TmpCount, false);
+		bool result = SteamInventory()->GetItemDefinitionIDs((SteamItemDef_t*)Items.GetData(), &TmpCount);
+		Items.SetNum(result ? TmpCount : 0, false);
 		return result;
 	}
 	return false;
@@ -114,13 +115,13 @@ bool USteamInventory::GetItemDefinitionIDs(TArray<FSteamItemDef>& Items) const
 
 bool USteamInventory::GetItemDefinitionProperty(FSteamItemDef Definition, const FString& PropertyName, FString& Value) const
 {
+	const FTCHARToUTF8 TmpPropertyName(*PropertyName);
 	uint32 Size = 0;
-	if (SteamInventory()->GetItemDefinitionProperty(Definition, TCHAR_TO_UTF8(*PropertyName), nullptr, &Size))
+	if (SteamInventory()->GetItemDefinitionProperty(Definition, TmpPropertyName.Get(), nullptr, &Size))
 	{
-		TArray<char> TmpStr;
-		TmpStr.SetNum(Size);
-		bool bResult = SteamInventory()->GetItemDefinitionProperty(Definition, TCHAR_TO_UTF8(*PropertyName), TmpStr.GetData(), &Size);
-		Value = UTF8_TO_TCHAR(TmpStr.GetData());
+		char* TmpStr = m_ScratchBuffer.Reserve(Size);
+		bool bResult = SteamInventory()->GetItemDefinitionProperty(Definition, TmpPropertyName.Get(), TmpStr, &Size);
+		USteamBridgeUtils::ConvertUTF8ToString(TmpStr, Size, Value);
 		return bResult;
 	}
 	return false;
@@ -164,11 +165,16 @@ bool USteamInventory::GetItemsWithPrices(TArray<FSteamItemPriceData>& ItemData)
 
 bool USteamInventory::GetResultItemProperty(FSteamInventoryResult ResultHandle, int32 ItemIndex, const FString& PropertyName, FString& Value) const
 {
-	TArray<char> TmpStr;
-	uint32 TmpStringValue = 0;
-	bool result = SteamInventory()->GetResultItemProperty(ResultHandle, ItemIndex, TCHAR_TO_UTF8(*PropertyName), TmpStr.GetData(), &TmpStringValue);
-	Value = UTF8_TO_TCHAR(TmpStr.GetData());
-	return result;
+	const FTCHARToUTF8 TmpPropertyName(*PropertyName);
+	uint32 Size = 0;
+	if (SteamInventory()->GetResultItemProperty(ResultHandle, ItemIndex, TmpPropertyName.Get(), nullptr, &Size))
+	{
+		char* TmpStr = m_ScratchBuffer.Reserve(Size);
+		bool bResult = SteamInventory()->GetResultItemProperty(ResultHandle, ItemIndex, TmpPropertyName.Get(), TmpStr, &Size);
+		USteamBridgeUtils::ConvertUTF8ToString(TmpStr, Size, Value);
+		return bResult;
+	}
+	return false;
 }
 
 bool USteamInventory::GetResultItems(FSteamInventoryResult ResultHandle, TArray<FSteamItemDetails>& ItemsArray) const
@@ -177,13 +183,13 @@ bool USteamInventory::GetResultItems(FSteamInventoryResult ResultHandle, TArray<
 
 	if (SteamInventory()->GetResultItems(ResultHandle, nullptr, &TmpCount))
 	{
-		TArray<SteamItemDetails_t> TmpArray;
-		TmpArray.SetNum(TmpCount);
-		bool result = SteamInventory()->GetResultItems(ResultHandle, TmpArray.GetData(), &TmpCount);
+		m_ResultItemsScratch.SetNumUninitialized(TmpCount, false);
+		bool result = SteamInventory()->GetResultItems(ResultHandle, m_ResultItemsScratch.GetData(), &TmpCount);
 
-		for (int32 i = 0; i < (int32)TmpCount; i++)
+		ItemsArray.Reserve(ItemsArray.Num() + TmpCount);
+		for (uint32 i = 0; i < TmpCount; i++)
 		{
-			ItemsArray.Add((FSteamItemDetails)TmpArray[i]);
+			ItemsArray.Emplace(m_ResultItemsScratch[i]);
 		}
 
 		return result;
@@ -0,0 +1,281 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamInventoryMirror.h"
+
+#include "Core/SteamInventory.h"
+
+USteamInventoryMirror::USteamInventoryMirror() :
+	m_RefreshHandle(k_SteamInventoryResultInvalid), m_LastFullUpdateHandle(k_SteamInventoryResultInvalid), m_bMirroring(false), m_bHasFullUpdate(false)
+{
+}
+
+bool USteamInventoryMirror::StartMirroring()
+{
+	if (!m_bMirroring)
+	{
+		m_bMirroring = true;
+
+		USteamInventory* const Inventory = USteamInventory::GetSteamInventory();
+		Inventory->m_OnSteamInventoryFullUpdate.AddUniqueDynamic(this, &USteamInventoryMirror::HandleFullUpdate);
+		Inventory->m_OnSteamInventoryResultReady.AddUniqueDynamic(this, &USteamInventoryMirror::HandleResultReady);
+	}
+
+	return Refresh();
+}
+
+void USteamInventoryMirror::StopMirroring()
+{
+	if (!m_bMirroring)
+	{
+		return;
+	}
+
+	USteamInventory* const Inventory = USteamInventory::GetSteamInventory();
+	Inventory->m_OnSteamInventoryFullUpdate.RemoveDynamic(this, &USteamInventoryMirror::HandleFullUpdate);
+	Inventory->m_OnSteamInventoryResultReady.RemoveDynamic(this, &USteamInventoryMirror::HandleResultReady);
+
+	if (m_RefreshHandle != k_SteamInventoryResultInvalid)
+	{
+		SteamInventory()->DestroyResult(m_RefreshHandle);
+		m_RefreshHandle = k_SteamInventoryResultInvalid;
+	}
+
+	m_bMirroring = false;
+	Reset();
+}
+
+bool USteamInventoryMirror::Refresh()
+{
+	if (!m_bMirroring)
+	{
+		return false;
+	}
+
+	// A refresh that's already in flight will deliver the same snapshot
+	if (m_RefreshHandle != k_SteamInventoryResultInvalid)
+	{
+		return true;
+	}
+
+	return SteamInventory()->GetAllItems(&m_RefreshHandle);
+}
+
+bool USteamInventoryMirror::GetItem(FSteamItemInstanceID ItemID, FSteamItemDetails& Item) const
+{
+	const int32 Slot = FindSlot(ItemID);
+	if (Slot == INDEX_NONE)
+	{
+		return false;
+	}
+
+	SteamItemDetails_t Details;
+	Details.m_itemId = m_InstanceIDs[Slot];
+	Details.m_iDefinition = m_Definitions[Slot];
+	Details.m_unQuantity = m_Quantities[Slot];
+	Details.m_unFlags = m_Flags[Slot];
+	Item = FSteamItemDetails(Details);
+	return true;
+}
+
+int32 USteamInventoryMirror::GetDefinitionQuantity(FSteamItemDef Definition) const
+{
+	const FDefinitionBucket* Bucket = m_Buckets.Find(Definition);
+	return Bucket != nullptr ? Bucket->TotalQuantity : 0;
+}
+
+int32 USteamInventoryMirror::GetDefinitionItems(FSteamItemDef Definition, TArray<FSteamItemInstanceID>& ItemIDs) const
+{
+	const FDefinitionBucket* Bucket = m_Buckets.Find(Definition);
+	if (Bucket == nullptr)
+	{
+		return 0;
+	}
+
+	ItemIDs.Reserve(ItemIDs.Num() + Bucket->InstanceIDs.Num());
+	for (const SteamItemInstanceID_t ItemID : Bucket->InstanceIDs)
+	{
+		ItemIDs.Emplace(ItemID);
+	}
+	return Bucket->InstanceIDs.Num();
+}
+
+int32 USteamInventoryMirror::FindSlot(SteamItemInstanceID_t ItemID) const
+{
+	const int32* Slot = m_IndexByInstance.Find(ItemID);
+	return Slot != nullptr ? *Slot : INDEX_NONE;
+}
+
+bool USteamInventoryMirror::ReadResultItems(SteamInventoryResult_t ResultHandle)
+{
+	uint32 Count = 0;
+	if (!SteamInventory()->GetResultItems(ResultHandle, nullptr, &Count))
+	{
+		return false;
+	}
+
+	m_ResultItems.SetNumUninitialized(Count, false);
+	return Count == 0 || SteamInventory()->GetResultItems(ResultHandle, m_ResultItems.GetData(), &Count);
+}
+
+void USteamInventoryMirror::ApplyFullUpdate()
+{
+	Reset();
+
+	m_InstanceIDs.Reserve(m_ResultItems.Num());
+	m_Definitions.Reserve(m_ResultItems.Num());
+	m_Quantities.Reserve(m_ResultItems.Num());
+	m_Flags.Reserve(m_ResultItems.Num());
+	m_IndexByInstance.Reserve(m_ResultItems.Num());
+
+	for (const SteamItemDetails_t& Details : m_ResultItems)
+	{
+		AddItem(Details);
+	}
+
+	m_bHasFullUpdate = true;
+}
+
+void USteamInventoryMirror::ApplyChangedItems()
+{
+	m_ChangedItems.Reset();
+
+	for (const SteamItemDetails_t& Details : m_ResultItems)
+	{
+		m_ChangedItems.Emplace(Details.m_itemId);
+
+		const int32 Slot = FindSlot(Details.m_itemId);
+		const bool bRemoved = (Details.m_unFlags & (k_ESteamItemRemoved | k_ESteamItemConsumed)) != 0 || Details.m_unQuantity == 0;
+
+		if (Slot == INDEX_NONE)
+		{
+			if (!bRemoved)
+			{
+				AddItem(Details);
+			}
+		}
+		else if (bRemoved || Details.m_iDefinition != m_Definitions[Slot])
+		{
+			RemoveSlot(Slot);
+			if (!bRemoved)
+			{
+				AddItem(Details);
+			}
+		}
+		else
+		{
+			m_Buckets.FindChecked(Details.m_iDefinition).TotalQuantity += (int32)Details.m_unQuantity - (int32)m_Quantities[Slot];
+			m_Quantities[Slot] = Details.m_unQuantity;
+			m_Flags[Slot] = Details.m_unFlags;
+		}
+	}
+}
+
+void USteamInventoryMirror::AddItem(const SteamItemDetails_t& Details)
+{
+	const int32 Slot = m_InstanceIDs.Add(Details.m_itemId);
+	m_Definitions.Add(Details.m_iDefinition);
+	m_Quantities.Add(Details.m_unQuantity);
+	m_Flags.Add(Details.m_unFlags);
+	m_IndexByInstance.Add(Details.m_itemId, Slot);
+
+	FDefinitionBucket& Bucket = m_Buckets.FindOrAdd(Details.m_iDefinition);
+	Bucket.TotalQuantity += Details.m_unQuantity;
+	Bucket.InstanceIDs.Add(Details.m_itemId);
+}
+
+void USteamInventoryMirror::RemoveSlot(int32 Slot)
+{
+	const SteamItemInstanceID_t ItemID = m_InstanceIDs[Slot];
+	const SteamItemDef_t Definition = m_Definitions[Slot];
+
+	FDefinitionBucket& Bucket = m_Buckets.FindChecked(Definition);
+	Bucket.TotalQuantity -= m_Quantities[Slot];
+	Bucket.InstanceIDs.RemoveSingleSwap(ItemID, false);
+	if (Bucket.InstanceIDs.Num() == 0)
+	{
+		m_Buckets.Remove(Definition);
+	}
+
+	m_IndexByInstance.Remove(ItemID);
+
+	// Move the last slot into the hole so the columns stay packed
+	const int32 LastSlot = m_InstanceIDs.Num() - 1;
+	if (Slot != LastSlot)
+	{
+		m_InstanceIDs[Slot] = m_InstanceIDs[LastSlot];
+		m_Definitions[Slot] = m_Definitions[LastSlot];
+		m_Quantities[Slot] = m_Quantities[LastSlot];
+		m_Flags[Slot] = m_Flags[LastSlot];
+		m_IndexByInstance[m_InstanceIDs[Slot]] = Slot;
+	}
+
+	m_InstanceIDs.Pop(false);
+	m_Definitions.Pop(false);
+	m_Quantities.Pop(false);
+	m_Flags.Pop(false);
+}
+
+void USteamInventoryMirror::Reset()
+{
+	m_InstanceIDs.Reset();
+	m_Definitions.Reset();
+	m_Quantities.Reset();
+	m_Flags.Reset();
+	m_IndexByInstance.Reset();
+	m_Buckets.Reset();
+	m_bHasFullUpdate = false;
+}
+
+void USteamInventoryMirror::HandleFullUpdate(FSteamInventoryResult ResultHandle)
+{
+	if (!ReadResultItems(ResultHandle))
+	{
+		return;
+	}
+
+	ApplyFullUpdate();
+	m_LastFullUpdateHandle = ResultHandle;
+
+	m_ChangedItems.Reset();
+	m_OnMirrorUpdated.Broadcast(true, m_ChangedItems);
+}
+
+void USteamInventoryMirror::HandleResultReady(FSteamInventoryResult ResultHandle, ESteamResult Result)
+{
+	// SteamInventoryFullUpdate_t is posted right before SteamInventoryResultReady_t for the same handle
+	const bool bAlreadyApplied = ResultHandle == m_LastFullUpdateHandle;
+	m_LastFullUpdateHandle = k_SteamInventoryResultInvalid;
+
+	if (ResultHandle == m_RefreshHandle)
+	{
+		// SteamInventoryFullUpdate_t is only posted when the snapshot is newer than the last one Steam knows,
+		// e.g. not after StopMirroring/StartMirroring or a refresh where nothing changed, so apply it here
+		if (!bAlreadyApplied && Result == ESteamResult::OK && ReadResultItems(ResultHandle))
+		{
+			ApplyFullUpdate();
+			m_ChangedItems.Reset();
+			m_OnMirrorUpdated.Broadcast(true, m_ChangedItems);
+		}
+
+		SteamInventory()->DestroyResult(m_RefreshHandle);
+		m_RefreshHandle = k_SteamInventoryResultInvalid;
+		return;
+	}
+
+	if (bAlreadyApplied || Result != ESteamResult::OK || !m_bHasFullUpdate)
+	{
+		return;
+	}
+
+	// Results from DeserializeResult belong to other players
+	if (SteamUser() == nullptr || !SteamInventory()->CheckResultSteamID(ResultHandle, SteamUser()->GetSteamID()))
+	{
+		return;
+	}
+
+	if (ReadResultItems(ResultHandle))
+	{
+		ApplyChangedItems();
+		m_OnMirrorUpdated.Broadcast(false, m_ChangedItems);
+	}
+}
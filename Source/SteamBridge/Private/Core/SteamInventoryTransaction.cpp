@@ -0,0 +1,172 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamInventoryTransaction.h"
+
+#include "Containers/Ticker.h"
+#include "Core/SteamInventory.h"
+
+USteamInventoryTransaction::USteamInventoryTransaction() :
+	m_NumFailed(0), m_bSubmitted(false)
+{
+}
+
+USteamInventoryTransaction* USteamInventoryTransaction::CreateInventoryTransaction()
+{
+	return NewObject<USteamInventoryTransaction>(GetTransientPackage());
+}
+
+void USteamInventoryTransaction::AddGenerateItem(FSteamItemDef ItemDef, int32 Quantity)
+{
+	if (m_bSubmitted || Quantity <= 0)
+	{
+		return;
+	}
+
+	const int32 Index = m_GenerateDefs.Find(ItemDef);
+	if (Index != INDEX_NONE)
+	{
+		m_GenerateQuantities[Index] += Quantity;
+	}
+	else
+	{
+		m_GenerateDefs.Add(ItemDef);
+		m_GenerateQuantities.Add(Quantity);
+	}
+}
+
+void USteamInventoryTransaction::AddExchange(FSteamItemDef ItemDef, const TMap<FSteamItemInstanceID, int32>& ItemsDestroyed)
+{
+	if (m_bSubmitted || ItemsDestroyed.Num() < 1)
+	{
+		return;
+	}
+
+	FExchange& Exchange = m_Exchanges.AddDefaulted_GetRef();
+	Exchange.Generate = ItemDef;
+	Exchange.DestroyStart = m_DestroyIDs.Num();
+	Exchange.DestroyNum = ItemsDestroyed.Num();
+
+	for (const auto& pair : ItemsDestroyed)
+	{
+		m_DestroyIDs.Add(pair.Key);
+		m_DestroyQuantities.Add(pair.Value);
+	}
+}
+
+void USteamInventoryTransaction::AddConsumeItem(FSteamItemInstanceID ItemID, int32 Quantity)
+{
+	if (m_bSubmitted || Quantity <= 0)
+	{
+		return;
+	}
+
+	m_Consumes.Add({ItemID, (uint32)Quantity});
+}
+
+void USteamInventoryTransaction::AddTransferItemQuantity(FSteamItemInstanceID ItemIdSource, int32 Quantity, FSteamItemInstanceID ItemIdDest)
+{
+	if (m_bSubmitted || Quantity <= 0)
+	{
+		return;
+	}
+
+	m_Transfers.Add({ItemIdSource, (uint32)Quantity, ItemIdDest});
+}
+
+bool USteamInventoryTransaction::Submit()
+{
+	if (m_bSubmitted || GetNumOperations() == 0)
+	{
+		return false;
+	}
+
+	m_bSubmitted = true;
+
+	// Keep the transaction alive until its results are ready, callers are free to drop their reference after submitting
+	AddToRoot();
+	USteamInventory::GetSteamInventory()->m_OnSteamInventoryResultReady.AddUniqueDynamic(this, &USteamInventoryTransaction::HandleResultReady);
+
+	ISteamInventory* const Inventory = SteamInventory();
+	SteamInventoryResult_t ResultHandle = k_SteamInventoryResultInvalid;
+
+	if (m_GenerateDefs.Num() > 0)
+	{
+		TrackResult(Inventory->GenerateItems(&ResultHandle, m_GenerateDefs.GetData(), m_GenerateQuantities.GetData(), m_GenerateDefs.Num()), ResultHandle);
+	}
+
+	// ExchangeItems only accepts a single generated item with a quantity of 1
+	const uint32 GenerateQuantity = 1;
+	for (const FExchange& Exchange : m_Exchanges)
+	{
+		TrackResult(Inventory->ExchangeItems(&ResultHandle, &Exchange.Generate, &GenerateQuantity, 1, m_DestroyIDs.GetData() + Exchange.DestroyStart, m_DestroyQuantities.GetData() + Exchange.DestroyStart, Exchange.DestroyNum), ResultHandle);
+	}
+
+	for (const FConsume& Consume : m_Consumes)
+	{
+		TrackResult(Inventory->ConsumeItem(&ResultHandle, Consume.ItemID, Consume.Quantity), ResultHandle);
+	}
+
+	for (const FTransfer& Transfer : m_Transfers)
+	{
+		TrackResult(Inventory->TransferItemQuantity(&ResultHandle, Transfer.Source, Transfer.Quantity, Transfer.Dest), ResultHandle);
+	}
+
+	if (m_PendingResults.Num() == 0)
+	{
+		Finish();
+	}
+	return true;
+}
+
+void USteamInventoryTransaction::TrackResult(bool bIssued, SteamInventoryResult_t ResultHandle)
+{
+	if (bIssued && ResultHandle != k_SteamInventoryResultInvalid)
+	{
+		m_PendingResults.Add(ResultHandle);
+	}
+	else
+	{
+		m_NumFailed++;
+	}
+}
+
+void USteamInventoryTransaction::Finish()
+{
+	USteamInventory::GetSteamInventory()->m_OnSteamInventoryResultReady.RemoveDynamic(this, &USteamInventoryTransaction::HandleResultReady);
+
+	// Other listeners of SteamInventoryResultReady_t (e.g. the inventory mirror) may not have read the results yet, destroy them on the next tick
+	FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float DeltaTime) {
+		for (const SteamInventoryResult_t ResultHandle : m_CompletedResults)
+		{
+			SteamInventory()->DestroyResult(ResultHandle);
+		}
+		m_CompletedResults.Reset();
+
+		m_OnTransactionCompleted.Broadcast(m_NumFailed == 0, m_NumFailed, m_Items);
+		RemoveFromRoot();
+		return false;
+	}));
+}
+
+void USteamInventoryTransaction::HandleResultReady(FSteamInventoryResult ResultHandle, ESteamResult Result)
+{
+	if (m_PendingResults.RemoveSingleSwap(ResultHandle, false) == 0)
+	{
+		return;
+	}
+
+	m_CompletedResults.Add(ResultHandle);
+	if (Result == ESteamResult::OK)
+	{
+		USteamInventory::GetSteamInventory()->GetResultItems(ResultHandle, m_Items);
+	}
+	else
+	{
+		m_NumFailed++;
+	}
+
+	if (m_PendingResults.Num() == 0)
+	{
+		Finish();
+	}
+}
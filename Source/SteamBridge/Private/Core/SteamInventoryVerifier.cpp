@@ -0,0 +1,161 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamInventoryVerifier.h"
+
+#include "Containers/Ticker.h"
+
+namespace
+{
+	// The pool only keeps enough buffers for one batch of blobs
+	constexpr int32 MaxPooledBuffers = 64;
+}  // namespace
+
+USteamInventoryVerifier::USteamInventoryVerifier() :
+	m_QueueHead(0), m_NextRequestID(1), m_MaxInFlight(32), m_bAllowExpiredResults(false)
+{
+}
+
+USteamInventoryVerifier::~USteamInventoryVerifier()
+{
+	if (m_TickHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(m_TickHandle);
+	}
+}
+
+int32 USteamInventoryVerifier::QueueVerification(FSteamID SteamID, const TArray<uint8>& Buffer)
+{
+	TArray<uint8> PooledBuffer = m_BufferPool.Num() > 0 ? m_BufferPool.Pop(false) : TArray<uint8>();
+	PooledBuffer.Reset();
+	PooledBuffer.Append(Buffer);
+	return Enqueue(SteamID, MoveTemp(PooledBuffer));
+}
+
+int32 USteamInventoryVerifier::QueueVerification(FSteamID SteamID, TArray<uint8>&& Buffer)
+{
+	return Enqueue(SteamID, MoveTemp(Buffer));
+}
+
+ISteamInventory* USteamInventoryVerifier::GetInventoryInterface()
+{
+	ISteamInventory* const ServerInventory = SteamGameServerInventory();
+	return ServerInventory != nullptr ? ServerInventory : SteamInventory();
+}
+
+int32 USteamInventoryVerifier::Enqueue(FSteamID SteamID, TArray<uint8>&& Buffer)
+{
+	const int32 RequestID = m_NextRequestID++;
+	m_Queue.Add({RequestID, SteamID, MoveTemp(Buffer)});
+
+	if (!m_TickHandle.IsValid())
+	{
+		m_TickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USteamInventoryVerifier::Tick));
+	}
+
+	return RequestID;
+}
+
+bool USteamInventoryVerifier::Tick(float DeltaTime)
+{
+	ISteamInventory* const Inventory = GetInventoryInterface();
+	if (Inventory == nullptr)
+	{
+		return true;
+	}
+
+	PollInFlight(Inventory);
+	IssueDeserializes(Inventory);
+
+	if (m_Completed.Num() > 0)
+	{
+		m_OnVerificationsCompleted.Broadcast(m_Completed);
+		m_Completed.Reset();
+	}
+
+	if (m_InFlight.Num() == 0 && m_QueueHead == m_Queue.Num())
+	{
+		m_Queue.Reset();
+		m_QueueHead = 0;
+		m_TickHandle.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+void USteamInventoryVerifier::IssueDeserializes(ISteamInventory* Inventory)
+{
+	while (m_InFlight.Num() < m_MaxInFlight && m_QueueHead < m_Queue.Num())
+	{
+		FQueuedBlob& Blob = m_Queue[m_QueueHead++];
+
+		// DeserializeResult copies what it needs, the buffer can be reused as soon as it returns
+		SteamInventoryResult_t ResultHandle = k_SteamInventoryResultInvalid;
+		if (Inventory->DeserializeResult(&ResultHandle, Blob.Buffer.GetData(), Blob.Buffer.Num(), false) && ResultHandle != k_SteamInventoryResultInvalid)
+		{
+			m_InFlight.Add({Blob.RequestID, Blob.SteamID, ResultHandle});
+		}
+		else
+		{
+			FSteamInventoryVerification& Verification = m_Completed.Emplace_GetRef(Blob.RequestID, Blob.SteamID);
+			Verification.Result = ESteamResult::Fail;
+		}
+
+		if (m_BufferPool.Num() < MaxPooledBuffers)
+		{
+			m_BufferPool.Add(MoveTemp(Blob.Buffer));
+		}
+		else
+		{
+			Blob.Buffer.Empty();
+		}
+	}
+
+	if (m_QueueHead > 0 && m_QueueHead * 2 >= m_Queue.Num())
+	{
+		m_Queue.RemoveAt(0, m_QueueHead, false);
+		m_QueueHead = 0;
+	}
+}
+
+void USteamInventoryVerifier::PollInFlight(ISteamInventory* Inventory)
+{
+	for (int32 i = m_InFlight.Num() - 1; i >= 0; i--)
+	{
+		const EResult Status = Inventory->GetResultStatus(m_InFlight[i].ResultHandle);
+		if (Status == k_EResultPending)
+		{
+			continue;
+		}
+
+		Complete(Inventory, m_InFlight[i], Status);
+		m_InFlight.RemoveAtSwap(i, 1, false);
+	}
+}
+
+void USteamInventoryVerifier::Complete(ISteamInventory* Inventory, const FInFlight& Request, EResult Status)
+{
+	FSteamInventoryVerification& Verification = m_Completed.Emplace_GetRef(Request.RequestID, Request.SteamID);
+	Verification.Result = (ESteamResult)Status;
+
+	const bool bStatusAccepted = Status == k_EResultOK || (Status == k_EResultExpired && m_bAllowExpiredResults);
+	if (bStatusAccepted && Inventory->CheckResultSteamID(Request.ResultHandle, CSteamID(Request.SteamID)))
+	{
+		uint32 Count = 0;
+		if (Inventory->GetResultItems(Request.ResultHandle, nullptr, &Count))
+		{
+			m_ItemScratch.SetNumUninitialized(Count, false);
+			if (Count == 0 || Inventory->GetResultItems(Request.ResultHandle, m_ItemScratch.GetData(), &Count))
+			{
+				Verification.bVerified = true;
+				Verification.Items.Reserve(Count);
+				for (uint32 i = 0; i < Count; i++)
+				{
+					Verification.Items.Emplace(m_ItemScratch[i]);
+				}
+			}
+		}
+	}
+
+	Inventory->DestroyResult(Request.ResultHandle);
+}
@@ -0,0 +1,568 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamItemCatalog.h"
+
+#include "Core/SteamInventory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "SteamBridgeUtils.h"
+
+namespace
+{
+	constexpr uint32 CatalogMagic = 0x53424943;  // SBIC
+	constexpr int32 CatalogVersion = 1;
+
+	bool ReadDefinitionProperty(SteamItemDef_t Definition, const char* PropertyName, TArray<char>& Buffer, FString& Value)
+	{
+		uint32 Size = 0;
+		if (!SteamInventory()->GetItemDefinitionProperty(Definition, PropertyName, nullptr, &Size))
+		{
+			return false;
+		}
+
+		Buffer.SetNumUninitialized(FMath::Max<int32>(Buffer.Num(), Size + 1), false);
+		Size = Buffer.Num();
+		if (!SteamInventory()->GetItemDefinitionProperty(Definition, PropertyName, Buffer.GetData(), &Size))
+		{
+			return false;
+		}
+
+		USteamBridgeUtils::ConvertUTF8ToString(Buffer.GetData(), Size, Value);
+		return true;
+	}
+
+	FString GetCurrentLanguage()
+	{
+		return SteamApps() != nullptr ? FString(UTF8_TO_TCHAR(SteamApps()->GetCurrentGameLanguage())) : FString();
+	}
+}  // namespace
+
+USteamItemCatalog::USteamItemCatalog() :
+	m_bLoaded(false), m_bFromCache(false), m_bStarted(false)
+{
+}
+
+bool USteamItemCatalog::StartCatalog()
+{
+	if (!m_bStarted)
+	{
+		m_bStarted = true;
+		USteamInventory::GetSteamInventory()->m_OnSteamInventoryDefinitionUpdate.AddUniqueDynamic(this, &USteamItemCatalog::HandleDefinitionUpdate);
+	}
+
+	// The definitions may already be loaded if something else triggered LoadItemDefinitions
+	if (Rebuild())
+	{
+		return true;
+	}
+
+	if (!m_bLoaded && LoadFromDisk())
+	{
+		m_OnCatalogUpdated.Broadcast(true);
+	}
+	return m_bLoaded;
+}
+
+bool USteamItemCatalog::Rebuild()
+{
+	uint32 Count = 0;
+	if (!SteamInventory()->GetItemDefinitionIDs(nullptr, &Count) || Count == 0)
+	{
+		return false;
+	}
+
+	TArray<SteamItemDef_t> Definitions;
+	Definitions.SetNumUninitialized(Count);
+	if (!SteamInventory()->GetItemDefinitionIDs(Definitions.GetData(), &Count))
+	{
+		return false;
+	}
+	Definitions.SetNum(Count, false);
+
+	Reset();
+	m_Language = GetCurrentLanguage();
+
+	m_Definitions.Reserve(Count);
+	m_Names.Reserve(Count);
+	m_Types.Reserve(Count);
+	m_TagRanges.Reserve(Count);
+	m_RecipeRanges.Reserve(Count);
+	m_PriceRanges.Reserve(Count);
+	m_PropertyRanges.Reserve(Count);
+	m_IndexByDefinition.Reserve(Count);
+
+	TArray<char> Buffer;
+	TArray<FString> PropertyNames;
+	FString PropertyList, Value;
+
+	for (const SteamItemDef_t Definition : Definitions)
+	{
+		// Passing a null property name returns a comma separated list of every property the definition has
+		if (!ReadDefinitionProperty(Definition, nullptr, Buffer, PropertyList))
+		{
+			continue;
+		}
+		PropertyList.ParseIntoArray(PropertyNames, TEXT(","), true);
+
+		const int32 TagStart = m_Tags.Num();
+		const int32 RecipeStart = m_Recipes.Num();
+		const int32 PriceStart = m_Prices.Num();
+		const int32 PropertyStart = m_Properties.Num();
+		int32 Name = INDEX_NONE, Type = INDEX_NONE;
+
+		for (const FString& PropertyName : PropertyNames)
+		{
+			if (!ReadDefinitionProperty(Definition, TCHAR_TO_UTF8(*PropertyName), Buffer, Value))
+			{
+				continue;
+			}
+
+			FStringPair& Property = m_Properties.AddDefaulted_GetRef();
+			Property.Key = Intern(PropertyName);
+			Property.Value = Intern(Value);
+
+			if (PropertyName == TEXT("name"))
+			{
+				Name = Property.Value;
+			}
+			else if (PropertyName == TEXT("type"))
+			{
+				Type = Property.Value;
+			}
+			else if (PropertyName == TEXT("tags"))
+			{
+				ParseTags(Value);
+			}
+			else if (PropertyName == TEXT("exchange"))
+			{
+				ParseExchange(Value);
+			}
+			else if (PropertyName == TEXT("price") || PropertyName == TEXT("price_category"))
+			{
+				ParsePrices(Value);
+			}
+		}
+
+		m_IndexByDefinition.Add(Definition, m_Definitions.Add(Definition));
+		m_Names.Add(Name);
+		m_Types.Add(Type);
+		m_TagRanges.Add({TagStart, m_Tags.Num() - TagStart});
+		m_RecipeRanges.Add({RecipeStart, m_Recipes.Num() - RecipeStart});
+		m_PriceRanges.Add({PriceStart, m_Prices.Num() - PriceStart});
+		m_PropertyRanges.Add({PropertyStart, m_Properties.Num() - PropertyStart});
+	}
+
+	m_bLoaded = true;
+	m_bFromCache = false;
+	SaveToDisk();
+
+	m_OnCatalogUpdated.Broadcast(false);
+	return true;
+}
+
+void USteamItemCatalog::GetDefinitionIDs(TArray<FSteamItemDef>& Definitions) const
+{
+	Definitions.Reset(m_Definitions.Num());
+	for (const SteamItemDef_t Definition : m_Definitions)
+	{
+		Definitions.Emplace(Definition);
+	}
+}
+
+FString USteamItemCatalog::GetDefinitionName(FSteamItemDef Definition) const
+{
+	const int32 Index = FindIndex(Definition);
+	return Index != INDEX_NONE && m_Names[Index] != INDEX_NONE ? m_Strings[m_Names[Index]] : FString();
+}
+
+FString USteamItemCatalog::GetDefinitionType(FSteamItemDef Definition) const
+{
+	const int32 Index = FindIndex(Definition);
+	return Index != INDEX_NONE && m_Types[Index] != INDEX_NONE ? m_Strings[m_Types[Index]] : FString();
+}
+
+bool USteamItemCatalog::GetDefinitionProperty(FSteamItemDef Definition, const FString& PropertyName, FString& Value) const
+{
+	const int32 Index = FindIndex(Definition);
+	const int32 Name = FindString(PropertyName);
+	if (Index == INDEX_NONE || Name == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const FRange& Range = m_PropertyRanges[Index];
+	for (int32 i = Range.Start; i < Range.Start + Range.Num; i++)
+	{
+		if (m_Properties[i].Key == Name)
+		{
+			Value = m_Strings[m_Properties[i].Value];
+			return true;
+		}
+	}
+	return false;
+}
+
+int32 USteamItemCatalog::GetDefinitionTags(FSteamItemDef Definition, TArray<FString>& Categories, TArray<FString>& Values) const
+{
+	const int32 Index = FindIndex(Definition);
+	if (Index == INDEX_NONE)
+	{
+		return 0;
+	}
+
+	const FRange& Range = m_TagRanges[Index];
+	Categories.Reserve(Categories.Num() + Range.Num);
+	Values.Reserve(Values.Num() + Range.Num);
+	for (int32 i = Range.Start; i < Range.Start + Range.Num; i++)
+	{
+		Categories.Add(m_Strings[m_Tags[i].Key]);
+		Values.Add(m_Strings[m_Tags[i].Value]);
+	}
+	return Range.Num;
+}
+
+bool USteamItemCatalog::HasTag(FSteamItemDef Definition, const FString& Category, const FString& Value) const
+{
+	const int32 Index = FindIndex(Definition);
+	const int32 CategoryIndex = FindString(Category);
+	const int32 ValueIndex = FindString(Value);
+	if (Index == INDEX_NONE || CategoryIndex == INDEX_NONE || ValueIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const FRange& Range = m_TagRanges[Index];
+	for (int32 i = Range.Start; i < Range.Start + Range.Num; i++)
+	{
+		if (m_Tags[i].Key == CategoryIndex && m_Tags[i].Value == ValueIndex)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void USteamItemCatalog::FindDefinitionsWithTag(const FString& Category, const FString& Value, TArray<FSteamItemDef>& Definitions) const
+{
+	const int32 CategoryIndex = FindString(Category);
+	const int32 ValueIndex = FindString(Value);
+	if (CategoryIndex == INDEX_NONE || ValueIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < m_Definitions.Num(); Index++)
+	{
+		const FRange& Range = m_TagRanges[Index];
+		for (int32 i = Range.Start; i < Range.Start + Range.Num; i++)
+		{
+			if (m_Tags[i].Key == CategoryIndex && m_Tags[i].Value == ValueIndex)
+			{
+				Definitions.Emplace(m_Definitions[Index]);
+				break;
+			}
+		}
+	}
+}
+
+int32 USteamItemCatalog::GetExchangeRecipes(FSteamItemDef Definition, TArray<FSteamItemRecipe>& Recipes) const
+{
+	const int32 Index = FindIndex(Definition);
+	if (Index == INDEX_NONE)
+	{
+		return 0;
+	}
+
+	const FRange& Range = m_RecipeRanges[Index];
+	Recipes.Reserve(Recipes.Num() + Range.Num);
+	for (int32 i = Range.Start; i < Range.Start + Range.Num; i++)
+	{
+		FSteamItemRecipe& Recipe = Recipes.AddDefaulted_GetRef();
+		Recipe.Materials.Reserve(m_Recipes[i].Num);
+		Recipe.Quantities.Reserve(m_Recipes[i].Num);
+		for (int32 j = m_Recipes[i].Start; j < m_Recipes[i].Start + m_Recipes[i].Num; j++)
+		{
+			Recipe.Materials.Emplace(m_RecipeComponents[j].Definition);
+			Recipe.Quantities.Add(m_RecipeComponents[j].Quantity);
+		}
+	}
+	return Range.Num;
+}
+
+bool USteamItemCatalog::GetPrice(FSteamItemDef Definition, const FString& Currency, int32& Amount) const
+{
+	const int32 Index = FindIndex(Definition);
+	const int32 CurrencyIndex = FindString(Currency);
+	if (Index == INDEX_NONE || CurrencyIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const FRange& Range = m_PriceRanges[Index];
+	for (int32 i = Range.Start; i < Range.Start + Range.Num; i++)
+	{
+		if (m_Prices[i].Currency == CurrencyIndex)
+		{
+			Amount = m_Prices[i].Amount;
+			return true;
+		}
+	}
+	return false;
+}
+
+int32 USteamItemCatalog::Intern(const FString& String)
+{
+	if (const int32* Index = m_StringIndices.Find(String))
+	{
+		return *Index;
+	}
+
+	const int32 Index = m_Strings.Add(String);
+	m_StringIndices.Add(String, Index);
+	return Index;
+}
+
+int32 USteamItemCatalog::FindString(const FString& String) const
+{
+	const int32* Index = m_StringIndices.Find(String);
+	return Index != nullptr ? *Index : INDEX_NONE;
+}
+
+int32 USteamItemCatalog::FindIndex(SteamItemDef_t Definition) const
+{
+	const int32* Index = m_IndexByDefinition.Find(Definition);
+	return Index != nullptr ? *Index : INDEX_NONE;
+}
+
+void USteamItemCatalog::ParseTags(const FString& Tags)
+{
+	// category:value;category:value
+	TArray<FString> Entries;
+	Tags.ParseIntoArray(Entries, TEXT(";"), true);
+
+	FString Category, Value;
+	for (const FString& Entry : Entries)
+	{
+		if (Entry.Split(TEXT(":"), &Category, &Value))
+		{
+			FStringPair& Tag = m_Tags.AddDefaulted_GetRef();
+			Tag.Key = Intern(Category.TrimStartAndEnd());
+			Tag.Value = Intern(Value.TrimStartAndEnd());
+		}
+	}
+}
+
+void USteamItemCatalog::ParseExchange(const FString& Exchange)
+{
+	// Recipes are separated by ';' and materials by ',', a material is "<itemdef>" or "<itemdef>x<quantity>"
+	TArray<FString> Recipes, Materials;
+	Exchange.ParseIntoArray(Recipes, TEXT(";"), true);
+
+	FString Definition, Quantity;
+	for (const FString& Recipe : Recipes)
+	{
+		const int32 Start = m_RecipeComponents.Num();
+		Recipe.ParseIntoArray(Materials, TEXT(","), true);
+
+		for (const FString& Material : Materials)
+		{
+			if (!Material.Split(TEXT("x"), &Definition, &Quantity))
+			{
+				Definition = Material;
+				Quantity.Reset();
+			}
+
+			Definition.TrimStartAndEndInline();
+			if (!Definition.IsNumeric())
+			{
+				continue;
+			}
+
+			FRecipeComponent& Component = m_RecipeComponents.AddDefaulted_GetRef();
+			Component.Definition = FCString::Atoi(*Definition);
+			Component.Quantity = Quantity.IsEmpty() ? 1 : FMath::Max(1, FCString::Atoi(*Quantity));
+		}
+
+		if (m_RecipeComponents.Num() > Start)
+		{
+			m_Recipes.Add({Start, m_RecipeComponents.Num() - Start});
+		}
+	}
+}
+
+void USteamItemCatalog::ParsePrices(const FString& Price)
+{
+	// <version>;<currency><amount>,<currency><amount> e.g. 1;VLV250 or 1;USD199,EUR179
+	FString Version, Entries;
+	if (!Price.Split(TEXT(";"), &Version, &Entries))
+	{
+		return;
+	}
+
+	TArray<FString> Amounts;
+	Entries.ParseIntoArray(Amounts, TEXT(","), true);
+	for (const FString& Amount : Amounts)
+	{
+		if (Amount.Len() > 3)
+		{
+			FPrice& Entry = m_Prices.AddDefaulted_GetRef();
+			Entry.Currency = Intern(Amount.Left(3));
+			Entry.Amount = FCString::Atoi(*Amount + 3);
+		}
+	}
+}
+
+void USteamItemCatalog::Reset()
+{
+	m_Strings.Reset();
+	m_StringIndices.Reset();
+	m_Definitions.Reset();
+	m_Names.Reset();
+	m_Types.Reset();
+	m_TagRanges.Reset();
+	m_RecipeRanges.Reset();
+	m_PriceRanges.Reset();
+	m_PropertyRanges.Reset();
+	m_Tags.Reset();
+	m_Recipes.Reset();
+	m_RecipeComponents.Reset();
+	m_Prices.Reset();
+	m_Properties.Reset();
+	m_IndexByDefinition.Reset();
+	m_Language.Reset();
+	m_bLoaded = false;
+}
+
+void USteamItemCatalog::SerializeCatalog(FArchive& Ar)
+{
+	Ar << m_Language << m_Strings;
+	Ar << m_Definitions << m_Names << m_Types << m_TagRanges << m_RecipeRanges << m_PriceRanges << m_PropertyRanges;
+	Ar << m_Tags << m_Recipes << m_RecipeComponents << m_Prices << m_Properties;
+}
+
+bool USteamItemCatalog::IsValidCatalog() const
+{
+	const int32 Count = m_Definitions.Num();
+	if (m_Names.Num() != Count || m_Types.Num() != Count || m_TagRanges.Num() != Count || m_RecipeRanges.Num() != Count || m_PriceRanges.Num() != Count ||
+		m_PropertyRanges.Num() != Count)
+	{
+		return false;
+	}
+
+	// Written so Start + Num can't overflow
+	const auto IsValidRange = [](const FRange& Range, int32 ColumnNum) { return Range.Start >= 0 && Range.Num >= 0 && Range.Start <= ColumnNum && Range.Num <= ColumnNum - Range.Start; };
+	const auto IsValidString = [this](int32 Index) { return Index >= 0 && Index < m_Strings.Num(); };
+	const auto IsValidOptionalString = [&IsValidString](int32 Index) { return Index == INDEX_NONE || IsValidString(Index); };
+
+	for (int32 i = 0; i < Count; i++)
+	{
+		if (!IsValidOptionalString(m_Names[i]) || !IsValidOptionalString(m_Types[i]) || !IsValidRange(m_TagRanges[i], m_Tags.Num()) ||
+			!IsValidRange(m_RecipeRanges[i], m_Recipes.Num()) || !IsValidRange(m_PriceRanges[i], m_Prices.Num()) || !IsValidRange(m_PropertyRanges[i], m_Properties.Num()))
+		{
+			return false;
+		}
+	}
+
+	for (const FRange& Recipe : m_Recipes)
+	{
+		if (!IsValidRange(Recipe, m_RecipeComponents.Num()))
+		{
+			return false;
+		}
+	}
+
+	for (const FStringPair& Tag : m_Tags)
+	{
+		if (!IsValidString(Tag.Key) || !IsValidString(Tag.Value))
+		{
+			return false;
+		}
+	}
+
+	for (const FStringPair& Property : m_Properties)
+	{
+		if (!IsValidString(Property.Key) || !IsValidString(Property.Value))
+		{
+			return false;
+		}
+	}
+
+	for (const FPrice& Price : m_Prices)
+	{
+		if (!IsValidOptionalString(Price.Currency))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool USteamItemCatalog::LoadFromDisk()
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *GetCachePath(), FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Ar(Data);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	Ar << Magic << Version;
+	if (Magic != CatalogMagic || Version != CatalogVersion)
+	{
+		return false;
+	}
+
+	Reset();
+	SerializeCatalog(Ar);
+
+	// Names and other properties are localized, a catalog saved in another language is useless.
+	// A truncated or corrupt file is rebuilt, the accessors index the columns without checking.
+	if (Ar.IsError() || m_Language != GetCurrentLanguage() || !IsValidCatalog())
+	{
+		Reset();
+		return false;
+	}
+
+	m_StringIndices.Reserve(m_Strings.Num());
+	for (int32 i = 0; i < m_Strings.Num(); i++)
+	{
+		m_StringIndices.Add(m_Strings[i], i);
+	}
+
+	m_IndexByDefinition.Reserve(m_Definitions.Num());
+	for (int32 i = 0; i < m_Definitions.Num(); i++)
+	{
+		m_IndexByDefinition.Add(m_Definitions[i], i);
+	}
+
+	m_bLoaded = true;
+	m_bFromCache = true;
+	return true;
+}
+
+void USteamItemCatalog::SaveToDisk()
+{
+	TArray<uint8> Data;
+	FMemoryWriter Ar(Data);
+
+	uint32 Magic = CatalogMagic;
+	int32 Version = CatalogVersion;
+	Ar << Magic << Version;
+	SerializeCatalog(Ar);
+
+	FFileHelper::SaveArrayToFile(Data, *GetCachePath());
+}
+
+FString USteamItemCatalog::GetCachePath() const
+{
+	return FPaths::ProjectSavedDir() / TEXT("SteamBridge/ItemCatalog.bin");
+}
+
+void USteamItemCatalog::HandleDefinitionUpdate()
+{
+	Rebuild();
+}
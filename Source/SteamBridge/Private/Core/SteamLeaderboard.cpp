@@ -0,0 +1,316 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamLeaderboard.h"
+
+#include "Algo/BinarySearch.h"
+
+namespace
+{
+	// Give up on a page Steam doesn't answer after this long
+	constexpr double DownloadTimeout = 15.0;
+
+	constexpr int32 MaxPageSize = 1000;
+}  // namespace
+
+USteamLeaderboard::USteamLeaderboard() :
+	m_SteamLeaderboard(0), m_PageSize(100), m_MaxDetails(0), m_MaxCachedEntries(20000), m_NumCachedEntries(0), m_InFlightPage(INDEX_NONE), m_InFlightTime(0.0), m_bDiscardInFlight(false), m_RequestedFirstRank(1), m_RequestedLastRank(1)
+{
+}
+
+USteamLeaderboard* USteamLeaderboard::CreateLeaderboard(FSteamLeaderboard SteamLeaderboard, int32 PageSize, int32 MaxDetails)
+{
+	USteamLeaderboard* const Leaderboard = NewObject<USteamLeaderboard>(GetTransientPackage());
+	Leaderboard->m_SteamLeaderboard = SteamLeaderboard;
+	Leaderboard->m_PageSize = FMath::Clamp(PageSize, 1, MaxPageSize);
+	Leaderboard->m_MaxDetails = FMath::Clamp(MaxDetails, 0, k_cLeaderboardDetailsMax);
+	return Leaderboard;
+}
+
+void USteamLeaderboard::RequestRange(int32 FirstRank, int32 LastRank)
+{
+	m_RequestedFirstRank = FMath::Max(1, FirstRank);
+	m_RequestedLastRank = FMath::Max(m_RequestedFirstRank, LastRank);
+
+	const int32 FirstPage = (m_RequestedFirstRank - 1) / m_PageSize;
+	const int32 LastPage = (m_RequestedLastRank - 1) / m_PageSize;
+
+	m_PageQueue.Reset();
+	for (int32 Page = FirstPage; Page <= LastPage; Page++)
+	{
+		QueuePage(Page);
+	}
+
+	// Lists are mostly scrolled down, prefetch the next page before the previous one
+	QueuePage(LastPage + 1);
+	QueuePage(FirstPage - 1);
+
+	EvictRanges();
+	DownloadNextPage();
+}
+
+bool USteamLeaderboard::IsRangeCached(int32 FirstRank, int32 LastRank) const
+{
+	const int32 Index = FindRange(FirstRank);
+	return Index != INDEX_NONE && m_Ranges[Index].LastRank() >= LastRank;
+}
+
+bool USteamLeaderboard::GetEntry(int32 Rank, FSteamLeaderboardEntry& Entry) const
+{
+	const TArrayView<const FSteamLeaderboardEntry> Entries = GetEntries(Rank, 1);
+	if (Entries.Num() == 0)
+	{
+		return false;
+	}
+
+	Entry = Entries[0];
+	return true;
+}
+
+int32 USteamLeaderboard::GetEntries(int32 FirstRank, int32 Count, TArray<FSteamLeaderboardEntry>& Entries) const
+{
+	const TArrayView<const FSteamLeaderboardEntry> Cached = GetEntries(FirstRank, Count);
+	Entries.Reset(Cached.Num());
+	Entries.Append(Cached.GetData(), Cached.Num());
+	return Cached.Num();
+}
+
+TArrayView<const FSteamLeaderboardEntry> USteamLeaderboard::GetEntries(int32 FirstRank, int32 Count) const
+{
+	const int32 Index = FindRange(FirstRank);
+	if (Index == INDEX_NONE || Count <= 0)
+	{
+		return TArrayView<const FSteamLeaderboardEntry>();
+	}
+
+	const FCachedRange& Range = m_Ranges[Index];
+	const int32 Offset = FirstRank - Range.FirstRank;
+	return MakeArrayView(Range.Entries.GetData() + Offset, FMath::Min(Count, Range.Entries.Num() - Offset));
+}
+
+bool USteamLeaderboard::GetEntryDetails(int32 Rank, TArray<int32>& Details) const
+{
+	const int32 Index = FindRange(Rank);
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const TArrayView<const int32> Cached = GetEntryDetails(Rank);
+	Details.Reset(Cached.Num());
+	Details.Append(Cached.GetData(), Cached.Num());
+	return true;
+}
+
+TArrayView<const int32> USteamLeaderboard::GetEntryDetails(int32 Rank) const
+{
+	const int32 Index = FindRange(Rank);
+	if (Index == INDEX_NONE || m_MaxDetails == 0)
+	{
+		return TArrayView<const int32>();
+	}
+
+	const FCachedRange& Range = m_Ranges[Index];
+	const int32 Offset = Rank - Range.FirstRank;
+	return MakeArrayView(Range.Details.GetData() + Offset * m_MaxDetails, FMath::Clamp(Range.Entries[Offset].Details, 0, m_MaxDetails));
+}
+
+void USteamLeaderboard::SetMaxCachedEntries(int32 MaxCachedEntries)
+{
+	m_MaxCachedEntries = FMath::Max(m_PageSize, MaxCachedEntries);
+	EvictRanges();
+}
+
+void USteamLeaderboard::Invalidate()
+{
+	m_Ranges.Empty();
+	m_NumCachedEntries = 0;
+	m_PageQueue.Reset();
+
+	// The page that's downloading may have been requested before the leaderboard changed
+	m_bDiscardInFlight = m_InFlightPage != INDEX_NONE;
+}
+
+int32 USteamLeaderboard::FindRange(int32 Rank) const
+{
+	const int32 Index = Algo::LowerBoundBy(m_Ranges, Rank, [](const FCachedRange& Range) { return Range.LastRank(); });
+	return Index < m_Ranges.Num() && m_Ranges[Index].FirstRank <= Rank ? Index : INDEX_NONE;
+}
+
+void USteamLeaderboard::QueuePage(int32 Page)
+{
+	if (Page < 0 || Page == m_InFlightPage || m_PageQueue.Contains(Page))
+	{
+		return;
+	}
+
+	const int32 TotalEntries = GetTotalEntryCount();
+	const int32 FirstRank = Page * m_PageSize + 1;
+	if (TotalEntries > 0 && FirstRank > TotalEntries)
+	{
+		return;
+	}
+
+	const int32 LastRank = TotalEntries > 0 ? FMath::Min(FirstRank + m_PageSize - 1, TotalEntries) : FirstRank + m_PageSize - 1;
+	if (!IsRangeCached(FirstRank, LastRank))
+	{
+		m_PageQueue.Add(Page);
+	}
+}
+
+void USteamLeaderboard::DownloadNextPage()
+{
+	if (m_InFlightPage != INDEX_NONE)
+	{
+		if (FPlatformTime::Seconds() - m_InFlightTime < DownloadTimeout)
+		{
+			return;
+		}
+		m_DownloadCall.Cancel();
+		m_InFlightPage = INDEX_NONE;
+		m_bDiscardInFlight = false;
+	}
+
+	while (m_PageQueue.Num() > 0)
+	{
+		const int32 Page = m_PageQueue[0];
+		m_PageQueue.RemoveAt(0, 1, false);
+
+		const int32 FirstRank = Page * m_PageSize + 1;
+		const SteamAPICall_t Call = SteamUserStats()->DownloadLeaderboardEntries(m_SteamLeaderboard, k_ELeaderboardDataRequestGlobal, FirstRank, FirstRank + m_PageSize - 1);
+		if (Call != k_uAPICallInvalid)
+		{
+			m_DownloadCall.Set(Call, this, &USteamLeaderboard::OnScoresDownloaded);
+			m_InFlightPage = Page;
+			m_InFlightTime = FPlatformTime::Seconds();
+			return;
+		}
+	}
+}
+
+void USteamLeaderboard::OnScoresDownloaded(LeaderboardScoresDownloaded_t* pParam, bool bIOFailure)
+{
+	const bool bDiscard = m_bDiscardInFlight;
+	m_InFlightPage = INDEX_NONE;
+	m_bDiscardInFlight = false;
+
+	// A page that failed isn't retried until it's requested again
+	if (bIOFailure || bDiscard)
+	{
+		DownloadNextPage();
+		return;
+	}
+
+	const SteamLeaderboardEntries_t LeaderboardEntries = pParam->m_hSteamLeaderboardEntries;
+	const int32 EntryCount = pParam->m_cEntryCount;
+
+	// Decode every row straight into the arrays of the new range, details are written in place with a fixed stride
+	FCachedRange NewRange;
+	NewRange.Entries.Reserve(EntryCount);
+	NewRange.Details.SetNumUninitialized(EntryCount * m_MaxDetails);
+
+	LeaderboardEntry_t TmpEntry;
+	for (int32 i = 0; i < EntryCount; i++)
+	{
+		if (!SteamUserStats()->GetDownloadedLeaderboardEntry(LeaderboardEntries, i, &TmpEntry, m_MaxDetails > 0 ? NewRange.Details.GetData() + i * m_MaxDetails : nullptr, m_MaxDetails))
+		{
+			break;
+		}
+		NewRange.Entries.Emplace(TmpEntry);
+	}
+	NewRange.Details.SetNum(NewRange.Entries.Num() * m_MaxDetails, false);
+
+	const int32 NumEntries = NewRange.Entries.Num();
+	NewRange.FirstRank = NumEntries > 0 ? NewRange.Entries[0].GlobalRank : 0;
+
+	// Only cache rows that cover one contiguous run of global ranks, the ranges are keyed by rank
+	const bool bContiguous = NumEntries > 0 && NewRange.Entries.Last().GlobalRank == NewRange.FirstRank + NumEntries - 1;
+	if (bContiguous)
+	{
+		const int32 FirstRank = NewRange.FirstRank;
+		InsertRange(MoveTemp(NewRange));
+		EvictRanges();
+		m_OnRangeCached.Broadcast(FirstRank, FirstRank + NumEntries - 1);
+	}
+
+	DownloadNextPage();
+}
+
+void USteamLeaderboard::InsertRange(FCachedRange&& NewRange)
+{
+	const int32 FirstRank = NewRange.FirstRank;
+	const int32 LastRank = NewRange.LastRank();
+
+	// Every cached range that overlaps or touches the new one is merged into it
+	const int32 Lo = Algo::LowerBoundBy(m_Ranges, FirstRank - 1, [](const FCachedRange& Range) { return Range.LastRank(); });
+	int32 Hi = Lo;
+	while (Hi < m_Ranges.Num() && m_Ranges[Hi].FirstRank <= LastRank + 1)
+	{
+		Hi++;
+	}
+
+	if (Lo == Hi)
+	{
+		m_NumCachedEntries += NewRange.Entries.Num();
+		m_Ranges.Insert(MoveTemp(NewRange), Lo);
+		return;
+	}
+
+	FCachedRange Merged;
+	Merged.FirstRank = FMath::Min(FirstRank, m_Ranges[Lo].FirstRank);
+	const int32 NumMerged = FMath::Max(LastRank, m_Ranges[Hi - 1].LastRank()) - Merged.FirstRank + 1;
+	Merged.Entries.SetNum(NumMerged);
+	Merged.Details.SetNumUninitialized(NumMerged * m_MaxDetails);
+
+	auto CopyRange = [this, &Merged](FCachedRange& Range) {
+		const int32 Offset = Range.FirstRank - Merged.FirstRank;
+		for (int32 i = 0; i < Range.Entries.Num(); i++)
+		{
+			Merged.Entries[Offset + i] = MoveTemp(Range.Entries[i]);
+		}
+		if (Range.Details.Num() > 0)
+		{
+			FMemory::Memcpy(Merged.Details.GetData() + Offset * m_MaxDetails, Range.Details.GetData(), Range.Details.Num() * sizeof(int32));
+		}
+	};
+
+	for (int32 i = Lo; i < Hi; i++)
+	{
+		m_NumCachedEntries -= m_Ranges[i].Entries.Num();
+		CopyRange(m_Ranges[i]);
+	}
+
+	// Copied last so the downloaded rows replace older copies of the same ranks
+	CopyRange(NewRange);
+	m_NumCachedEntries += NumMerged;
+
+	m_Ranges.RemoveAt(Lo, Hi - Lo, false);
+	m_Ranges.Insert(MoveTemp(Merged), Lo);
+}
+
+void USteamLeaderboard::EvictRanges()
+{
+	while (m_NumCachedEntries > m_MaxCachedEntries && m_Ranges.Num() > 0)
+	{
+		int32 FurthestIndex = INDEX_NONE;
+		int32 FurthestDistance = 0;
+		for (int32 i = 0; i < m_Ranges.Num(); i++)
+		{
+			const FCachedRange& Range = m_Ranges[i];
+			const int32 Distance = Range.LastRank() < m_RequestedFirstRank ? m_RequestedFirstRank - Range.LastRank() : FMath::Max(0, Range.FirstRank - m_RequestedLastRank);
+			if (Distance > FurthestDistance)
+			{
+				FurthestIndex = i;
+				FurthestDistance = Distance;
+			}
+		}
+
+		// Never drop the range that's on screen
+		if (FurthestIndex == INDEX_NONE)
+		{
+			break;
+		}
+
+		m_NumCachedEntries -= m_Ranges[FurthestIndex].Entries.Num();
+		m_Ranges.RemoveAt(FurthestIndex);
+	}
+}
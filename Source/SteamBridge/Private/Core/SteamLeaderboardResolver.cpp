@@ -0,0 +1,159 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamLeaderboardResolver.h"
+
+#include "SteamBridgeSettings.h"
+
+bool USteamLeaderboardResolver::ResolveLeaderboard(const FString& LeaderboardName, FSteamLeaderboard& SteamLeaderboard)
+{
+	if (const FCachedLeaderboard* const Cached = m_Cache.Find(LeaderboardName))
+	{
+		SteamLeaderboard = Cached->Leaderboard;
+		return true;
+	}
+
+	// Blueprint callers wait for the delegate, a lookup that can't be issued fails right away
+	if (StartLookup(LeaderboardName) == nullptr)
+	{
+		m_OnLeaderboardResolved.Broadcast(LeaderboardName, 0, false);
+	}
+	return false;
+}
+
+bool USteamLeaderboardResolver::ResolveOrCreateLeaderboard(const FString& LeaderboardName, ESteamLeaderboardSortMethod LeaderboardSortMethod, ESteamLeaderboardDisplayType LeaderboardDisplayType, FSteamLeaderboard& SteamLeaderboard)
+{
+	if (const FCachedLeaderboard* const Cached = m_Cache.Find(LeaderboardName))
+	{
+		SteamLeaderboard = Cached->Leaderboard;
+		return true;
+	}
+
+	if (StartLookup(LeaderboardName, true, (ELeaderboardSortMethod)LeaderboardSortMethod, (ELeaderboardDisplayType)LeaderboardDisplayType) == nullptr)
+	{
+		m_OnLeaderboardResolved.Broadcast(LeaderboardName, 0, false);
+	}
+	return false;
+}
+
+void USteamLeaderboardResolver::ResolveLeaderboard(const FString& LeaderboardName, TFunction<void(FSteamLeaderboard, bool)>&& OnResolved)
+{
+	if (const FCachedLeaderboard* const Cached = m_Cache.Find(LeaderboardName))
+	{
+		OnResolved(Cached->Leaderboard, true);
+		return;
+	}
+
+	if (FLookup* const Lookup = StartLookup(LeaderboardName))
+	{
+		Lookup->Callbacks.Add(MoveTemp(OnResolved));
+	}
+	else
+	{
+		OnResolved(0, false);
+	}
+}
+
+bool USteamLeaderboardResolver::GetCachedLeaderboard(const FString& LeaderboardName, FSteamLeaderboard& SteamLeaderboard, ESteamLeaderboardSortMethod& LeaderboardSortMethod, ESteamLeaderboardDisplayType& LeaderboardDisplayType) const
+{
+	const FCachedLeaderboard* const Cached = m_Cache.Find(LeaderboardName);
+	if (Cached == nullptr)
+	{
+		return false;
+	}
+
+	SteamLeaderboard = Cached->Leaderboard;
+	LeaderboardSortMethod = (ESteamLeaderboardSortMethod)Cached->SortMethod;
+	LeaderboardDisplayType = (ESteamLeaderboardDisplayType)Cached->DisplayType;
+	return true;
+}
+
+void USteamLeaderboardResolver::WarmUpLeaderboards()
+{
+	for (const FString& LeaderboardName : GetDefault<USteamBridgeSettings>()->WarmUpLeaderboards)
+	{
+		if (!LeaderboardName.IsEmpty() && !m_Cache.Contains(LeaderboardName))
+		{
+			StartLookup(LeaderboardName);
+		}
+	}
+}
+
+USteamLeaderboardResolver::FLookup* USteamLeaderboardResolver::StartLookup(const FString& LeaderboardName, bool bCreate, ELeaderboardSortMethod SortMethod, ELeaderboardDisplayType DisplayType)
+{
+	// Concurrent lookups of the same name share one call, a pending plain lookup is upgraded to FindOrCreateLeaderboard if it misses
+	if (const TUniquePtr<FLookup>* const Pending = m_Lookups.Find(LeaderboardName))
+	{
+		FLookup* const Lookup = Pending->Get();
+		if (bCreate && !Lookup->bCreate)
+		{
+			Lookup->bCreate = true;
+			Lookup->SortMethod = SortMethod;
+			Lookup->DisplayType = DisplayType;
+		}
+		return Lookup;
+	}
+
+	// A new lookup that may create the leaderboard sends FindOrCreateLeaderboard right away, it's one round trip either way
+	TUniquePtr<FLookup> Lookup = MakeUnique<FLookup>();
+	Lookup->Owner = this;
+	Lookup->Name = LeaderboardName;
+	Lookup->bCreate = bCreate;
+	Lookup->bCreateIssued = false;
+	Lookup->SortMethod = SortMethod;
+	Lookup->DisplayType = DisplayType;
+
+	if (!IssueLookup(*Lookup))
+	{
+		return nullptr;
+	}
+	return m_Lookups.Add(LeaderboardName, MoveTemp(Lookup)).Get();
+}
+
+bool USteamLeaderboardResolver::IssueLookup(FLookup& Lookup)
+{
+	FTCHARToUTF8 Name(*Lookup.Name);
+	const SteamAPICall_t Call = Lookup.bCreate ? SteamUserStats()->FindOrCreateLeaderboard(Name.Get(), Lookup.SortMethod, Lookup.DisplayType) : SteamUserStats()->FindLeaderboard(Name.Get());
+	if (Call == k_uAPICallInvalid)
+	{
+		return false;
+	}
+
+	Lookup.bCreateIssued = Lookup.bCreate;
+	Lookup.CallResult.Set(Call, &Lookup, &FLookup::OnFindResult);
+	return true;
+}
+
+void USteamLeaderboardResolver::HandleFindResult(FLookup& Lookup, LeaderboardFindResult_t* pParam, bool bIOFailure)
+{
+	m_FinishedLookups.Reset();
+
+	const bool bFound = !bIOFailure && pParam->m_bLeaderboardFound != 0;
+
+	// A caller asked for the leaderboard to be created while the plain lookup was pending
+	if (!bFound && Lookup.bCreate && !Lookup.bCreateIssued && IssueLookup(Lookup))
+	{
+		return;
+	}
+
+	FinishLookup(Lookup, bFound ? pParam->m_hSteamLeaderboard : 0, bFound);
+}
+
+void USteamLeaderboardResolver::FinishLookup(FLookup& Lookup, SteamLeaderboard_t Leaderboard, bool bFound)
+{
+	// Misses aren't cached, the leaderboard may be created later in the session
+	if (bFound)
+	{
+		m_Cache.Add(Lookup.Name, {Leaderboard, SteamUserStats()->GetLeaderboardSortMethod(Leaderboard), SteamUserStats()->GetLeaderboardDisplayType(Leaderboard)});
+	}
+
+	TUniquePtr<FLookup> Finished;
+	m_Lookups.RemoveAndCopyValue(Lookup.Name, Finished);
+
+	for (const TFunction<void(FSteamLeaderboard, bool)>& Callback : Lookup.Callbacks)
+	{
+		Callback(Leaderboard, bFound);
+	}
+	m_OnLeaderboardResolved.Broadcast(Lookup.Name, Leaderboard, bFound);
+
+	m_FinishedLookups.Add(MoveTemp(Finished));
+}
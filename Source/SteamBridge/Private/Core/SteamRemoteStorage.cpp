@@ -2,9 +2,17 @@
 
 #include "Core/SteamRemoteStorage.h"
 
+#include "SteamBridgeSettings.h"
 #include "SteamBridgeUtils.h"
 
-USteamRemoteStorage::USteamRemoteStorage()
+namespace
+{
+	// Enough for a few saves in flight, larger pools only keep memory alive between autosaves
+	constexpr int32 MaxPooledBuffers = 4;
+}  // namespace
+
+USteamRemoteStorage::USteamRemoteStorage() :
+	m_NumUntrackedWrites(0), m_bManifestValid(false)
 {
 	OnRemoteStorageDownloadUGCResultCallback.Register(this, &USteamRemoteStorage::OnRemoteStorageDownloadUGCResult);
 	OnRemoteStorageFileReadAsyncCompleteCallback.Register(this, &USteamRemoteStorage::OnRemoteStorageFileReadAsyncComplete);
@@ -28,14 +36,217 @@ USteamRemoteStorage::~USteamRemoteStorage()
 	OnRemoteStorageUnsubscribePublishedFileResultCallback.Unregister();
 }
 
-int32 USteamRemoteStorage::FileRead(const FString& FileName, TArray<uint8>& Data, int32 DataToRead) const
+bool USteamRemoteStorage::FileDelete(const FString& FileName)
+{
+	const bool bResult = SteamRemoteStorage()->FileDelete(TCHAR_TO_UTF8(*FileName));
+	if (bResult)
+	{
+		m_Manifest.Remove(FileName);
+	}
+	return bResult;
+}
+
+bool USteamRemoteStorage::FileForget(const FString& FileName)
+{
+	const bool bResult = SteamRemoteStorage()->FileForget(TCHAR_TO_UTF8(*FileName));
+	if (FCloudFile* const File = bResult ? m_Manifest.Find(FileName) : nullptr)
+	{
+		File->bPersisted = false;
+	}
+	return bResult;
+}
+
+int32 USteamRemoteStorage::FileRead(const FString& FileName, TArray<uint8>& Data, int32 DataToRead)
 {
 	Data.SetNum(DataToRead);
 	int32 result = SteamRemoteStorage()->FileRead(TCHAR_TO_UTF8(*FileName), Data.GetData(), Data.Num());
 	Data.SetNum(result);
+	if (result > 0)
+	{
+		TouchManifestEntry(FileName);
+	}
 	return result;
 }
 
+bool USteamRemoteStorage::FileReadAsyncComplete(FSteamAPICall ReadCall, TArray<uint8>& Data, int32 DataToRead) const
+{
+	Data.SetNumUninitialized(FMath::Max(0, DataToRead));
+	const bool bResult = SteamRemoteStorage()->FileReadAsyncComplete(ReadCall, Data.GetData(), Data.Num());
+	if (!bResult)
+	{
+		Data.Reset();
+	}
+	return bResult;
+}
+
+TFuture<FSteamCloudReadResult> USteamRemoteStorage::ReadFileAsync(const FString& FileName)
+{
+	FTCHARToUTF8 Name(*FileName);
+	const int32 FileSize = SteamRemoteStorage()->GetFileSize(Name.Get());
+	const SteamAPICall_t ReadCall = FileSize > 0 ? SteamRemoteStorage()->FileReadAsync(Name.Get(), 0, FileSize) : k_uAPICallInvalid;
+	if (ReadCall == k_uAPICallInvalid)
+	{
+		TPromise<FSteamCloudReadResult> Promise;
+		Promise.SetValue(FSteamCloudReadResult{FileSize > 0 ? ESteamResult::Fail : ESteamResult::FileNotFound, TArray<uint8>()});
+		return Promise.GetFuture();
+	}
+
+	TouchManifestEntry(FileName);
+	return m_PendingReads.Add(ReadCall).GetFuture();
+}
+
+bool USteamRemoteStorage::FileWrite(const FString& FileName, const TArray<uint8>& Data)
+{
+	MakeCloudSpace(Data.Num(), FileName);
+
+	const bool bResult = SteamRemoteStorage()->FileWrite(TCHAR_TO_UTF8(*FileName), Data.GetData(), Data.Num());
+	if (bResult)
+	{
+		RefreshManifestEntry(FileName);
+	}
+	return bResult;
+}
+
+FSteamAPICall USteamRemoteStorage::FileWriteAsync(const FString& FileName, const TArray<uint8>& Data)
+{
+	MakeCloudSpace(Data.Num(), FileName);
+
+	const SteamAPICall_t WriteCall = SteamRemoteStorage()->FileWriteAsync(TCHAR_TO_UTF8(*FileName), Data.GetData(), Data.Num());
+	if (WriteCall != k_uAPICallInvalid)
+	{
+		m_NumUntrackedWrites++;
+	}
+	return WriteCall;
+}
+
+TFuture<ESteamResult> USteamRemoteStorage::WriteFileAsync(const FString& FileName, TArray<uint8>&& Data)
+{
+	MakeCloudSpace(Data.Num(), FileName);
+
+	const SteamAPICall_t WriteCall = SteamRemoteStorage()->FileWriteAsync(TCHAR_TO_UTF8(*FileName), Data.GetData(), Data.Num());
+	if (WriteCall == k_uAPICallInvalid)
+	{
+		ReleaseBuffer(MoveTemp(Data));
+
+		TPromise<ESteamResult> Promise;
+		Promise.SetValue(ESteamResult::Fail);
+		return Promise.GetFuture();
+	}
+
+	FPendingWrite& Write = *m_PendingWrites.Add_GetRef(MakeUnique<FPendingWrite>());
+	Write.Owner = this;
+	Write.FileName = FileName;
+	Write.Data = MoveTemp(Data);
+	Write.CallResult.Set(WriteCall, &Write, &FPendingWrite::OnWriteComplete);
+	return Write.Promise.GetFuture();
+}
+
+TArray<uint8> USteamRemoteStorage::AcquireBuffer()
+{
+	return m_BufferPool.Num() > 0 ? m_BufferPool.Pop(false) : TArray<uint8>();
+}
+
+void USteamRemoteStorage::ReleaseBuffer(TArray<uint8>&& Buffer)
+{
+	if (m_BufferPool.Num() < MaxPooledBuffers)
+	{
+		Buffer.Reset();
+		m_BufferPool.Add(MoveTemp(Buffer));
+	}
+}
+
+void USteamRemoteStorage::HandleWriteComplete(FPendingWrite& Write, RemoteStorageFileWriteAsyncComplete_t* pParam, bool bIOFailure)
+{
+	m_FinishedWrites.Reset();
+
+	ReleaseBuffer(MoveTemp(Write.Data));
+
+	const ESteamResult Result = bIOFailure ? ESteamResult::IOFailure : (ESteamResult)pParam->m_eResult;
+	if (Result == ESteamResult::OK)
+	{
+		RefreshManifestEntry(Write.FileName);
+	}
+	Write.Promise.SetValue(Result);
+
+	const int32 Index = m_PendingWrites.IndexOfByPredicate([&Write](const TUniquePtr<FPendingWrite>& Pending) { return Pending.Get() == &Write; });
+	if (Index != INDEX_NONE)
+	{
+		m_FinishedWrites.Add(MoveTemp(m_PendingWrites[Index]));
+		m_PendingWrites.RemoveAtSwap(Index, 1, false);
+	}
+}
+
+void USteamRemoteStorage::GetCloudFiles(TArray<FSteamCloudFile>& Files)
+{
+	if (!m_bManifestValid)
+	{
+		BuildManifest();
+	}
+
+	Files.Reset(m_Manifest.Num());
+	for (const TPair<FString, FCloudFile>& Entry : m_Manifest)
+	{
+		Files.Emplace(Entry.Key, Entry.Value.Size, Entry.Value.Timestamp, Entry.Value.bPersisted, IsFileCritical(Entry.Key));
+	}
+}
+
+bool USteamRemoteStorage::GetCloudFile(const FString& FileName, FSteamCloudFile& File)
+{
+	if (!m_bManifestValid)
+	{
+		BuildManifest();
+	}
+
+	const FCloudFile* const Cached = m_Manifest.Find(FileName);
+	if (Cached == nullptr)
+	{
+		return false;
+	}
+
+	File = FSteamCloudFile(FileName, Cached->Size, Cached->Timestamp, Cached->bPersisted, IsFileCritical(FileName));
+	return true;
+}
+
+void USteamRemoteStorage::SetFileCritical(const FString& FileName, bool bCritical)
+{
+	if (bCritical)
+	{
+		m_CriticalFiles.Add(FileName);
+	}
+	else
+	{
+		m_CriticalFiles.Remove(FileName);
+	}
+}
+
+FUGCFileWriteStreamHandle USteamRemoteStorage::FileWriteStreamOpen(const FString& FileName)
+{
+	const UGCFileWriteStreamHandle_t WriteHandle = SteamRemoteStorage()->FileWriteStreamOpen(TCHAR_TO_UTF8(*FileName));
+	if (WriteHandle != k_UGCFileStreamHandleInvalid)
+	{
+		m_OpenWriteStreams.Add(WriteHandle, FileName);
+	}
+	return WriteHandle;
+}
+
+bool USteamRemoteStorage::FileWriteStreamClose(FUGCFileWriteStreamHandle WriteHandle)
+{
+	const bool bResult = SteamRemoteStorage()->FileWriteStreamClose(WriteHandle);
+
+	FString FileName;
+	if (m_OpenWriteStreams.RemoveAndCopyValue(WriteHandle, FileName) && bResult)
+	{
+		RefreshManifestEntry(FileName);
+	}
+	return bResult;
+}
+
+bool USteamRemoteStorage::FileWriteStreamCancel(FUGCFileWriteStreamHandle WriteHandle)
+{
+	m_OpenWriteStreams.Remove(WriteHandle);
+	return SteamRemoteStorage()->FileWriteStreamCancel(WriteHandle);
+}
+
 bool USteamRemoteStorage::GetQuota(int64& TotalBytes, int64& AvailableBytes) const
 {
 	uint64 TmpTotal, TmpAvailable;
@@ -45,6 +256,150 @@ bool USteamRemoteStorage::GetQuota(int64& TotalBytes, int64& AvailableBytes) con
 	return bResult;
 }
 
+bool USteamRemoteStorage::GetUGCDetails(FUGCHandle ContentHandle, int32& AppID, FString& FileName, int32& FileSizeInBytes, FSteamID& SteamIDOwner) const
+{
+	AppId_t TmpAppID = 0;
+	char* TmpName = nullptr;
+	CSteamID TmpOwner;
+	const bool bResult = SteamRemoteStorage()->GetUGCDetails(ContentHandle, &TmpAppID, &TmpName, &FileSizeInBytes, &TmpOwner);
+	AppID = TmpAppID;
+	FileName = bResult && TmpName != nullptr ? UTF8_TO_TCHAR(TmpName) : TEXT("");
+	SteamIDOwner = TmpOwner.ConvertToUint64();
+	return bResult;
+}
+
+int32 USteamRemoteStorage::UGCRead(FUGCHandle ContentHandle, TArray<uint8>& Data, int32 DataToRead, int32 Offset, ESteamUGCReadAction Action) const
+{
+	Data.SetNumUninitialized(FMath::Max(0, DataToRead));
+	const int32 BytesRead = SteamRemoteStorage()->UGCRead(ContentHandle, Data.GetData(), Data.Num(), (uint32)Offset, (EUGCReadAction)Action);
+	Data.SetNum(FMath::Max(0, BytesRead), false);
+	return BytesRead;
+}
+
+void USteamRemoteStorage::BuildManifest()
+{
+	// Keep the recency of files that were used before the manifest was invalidated
+	TMap<FString, FCloudFile> Previous = MoveTemp(m_Manifest);
+	m_Manifest.Reset();
+
+	ISteamRemoteStorage* const RemoteStorage = SteamRemoteStorage();
+	const int32 FileCount = RemoteStorage->GetFileCount();
+	m_Manifest.Reserve(FileCount);
+	for (int32 i = 0; i < FileCount; i++)
+	{
+		int32 FileSize = 0;
+		const char* const Name = RemoteStorage->GetFileNameAndSize(i, &FileSize);
+		if (Name == nullptr || *Name == '\0')
+		{
+			continue;
+		}
+
+		const int64 Timestamp = RemoteStorage->GetFileTimestamp(Name);
+		FString FileName(UTF8_TO_TCHAR(Name));
+		const FCloudFile* const Old = Previous.Find(FileName);
+		m_Manifest.Add(MoveTemp(FileName), {FileSize, Timestamp, Old != nullptr ? FMath::Max(Old->LastUsed, Timestamp) : Timestamp, RemoteStorage->FilePersisted(Name)});
+	}
+
+	m_bManifestValid = true;
+}
+
+void USteamRemoteStorage::RefreshManifestEntry(const FString& FileName)
+{
+	// Only kept up to date once it's built, an invalid manifest reads everything again anyway
+	if (!m_bManifestValid)
+	{
+		return;
+	}
+
+	FTCHARToUTF8 Name(*FileName);
+	ISteamRemoteStorage* const RemoteStorage = SteamRemoteStorage();
+	if (!RemoteStorage->FileExists(Name.Get()))
+	{
+		m_Manifest.Remove(FileName);
+		return;
+	}
+
+	FCloudFile& File = m_Manifest.FindOrAdd(FileName);
+	File.Size = RemoteStorage->GetFileSize(Name.Get());
+	File.Timestamp = RemoteStorage->GetFileTimestamp(Name.Get());
+	File.LastUsed = FDateTime::UtcNow().ToUnixTimestamp();
+	File.bPersisted = RemoteStorage->FilePersisted(Name.Get());
+}
+
+void USteamRemoteStorage::TouchManifestEntry(const FString& FileName)
+{
+	if (FCloudFile* const File = m_Manifest.Find(FileName))
+	{
+		File->LastUsed = FDateTime::UtcNow().ToUnixTimestamp();
+	}
+}
+
+bool USteamRemoteStorage::IsFileCritical(const FString& FileName) const
+{
+	if (m_CriticalFiles.Contains(FileName))
+	{
+		return true;
+	}
+
+	for (const FString& Pattern : GetDefault<USteamBridgeSettings>()->CloudCriticalFiles)
+	{
+		if (FileName.MatchesWildcard(Pattern))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool USteamRemoteStorage::MakeCloudSpace(int64 Bytes, const FString& WritingFileName)
+{
+	uint64 TotalBytes = 0, AvailableBytes = 0;
+	if (!SteamRemoteStorage()->GetQuota(&TotalBytes, &AvailableBytes))
+	{
+		return false;
+	}
+
+	const int64 Required = Bytes + GetDefault<USteamBridgeSettings>()->CloudReserveBytes;
+	int64 Available = (int64)AvailableBytes;
+	if (Available >= Required)
+	{
+		return true;
+	}
+
+	if (!m_bManifestValid)
+	{
+		BuildManifest();
+	}
+
+	// Overwriting a persisted file frees its old size
+	if (const FCloudFile* const Existing = m_Manifest.Find(WritingFileName))
+	{
+		Available += Existing->bPersisted ? Existing->Size : 0;
+	}
+
+	TArray<TPair<int64, const FString*>> Candidates;
+	for (const TPair<FString, FCloudFile>& Entry : m_Manifest)
+	{
+		if (Entry.Value.bPersisted && Entry.Key != WritingFileName && !IsFileCritical(Entry.Key))
+		{
+			Candidates.Emplace(Entry.Value.LastUsed, &Entry.Key);
+		}
+	}
+	Candidates.Sort([](const TPair<int64, const FString*>& A, const TPair<int64, const FString*>& B) { return A.Key < B.Key; });
+
+	ISteamRemoteStorage* const RemoteStorage = SteamRemoteStorage();
+	for (int32 i = 0; i < Candidates.Num() && Available < Required; i++)
+	{
+		FCloudFile& File = m_Manifest[*Candidates[i].Value];
+		if (RemoteStorage->FileForget(TCHAR_TO_UTF8(**Candidates[i].Value)))
+		{
+			File.bPersisted = false;
+			Available += File.Size;
+		}
+	}
+	return Available >= Required;
+}
+
 void USteamRemoteStorage::OnRemoteStorageDownloadUGCResult(RemoteStorageDownloadUGCResult_t* pParam)
 {
 	m_OnRemoteStorageDownloadUGCResult.Broadcast((ESteamResult)pParam->m_eResult, pParam->m_hFile, pParam->m_nAppID, pParam->m_nSizeInBytes, UTF8_TO_TCHAR(pParam->m_pchFileName), pParam->m_ulSteamIDOwner);
@@ -52,6 +407,22 @@ void USteamRemoteStorage::OnRemoteStorageDownloadUGCResult(RemoteStorageDownload
 
 void USteamRemoteStorage::OnRemoteStorageFileReadAsyncComplete(RemoteStorageFileReadAsyncComplete_t* pParam)
 {
+	TPromise<FSteamCloudReadResult> Promise;
+	if (m_PendingReads.RemoveAndCopyValue(pParam->m_hFileReadAsync, Promise))
+	{
+		FSteamCloudReadResult ReadResult{(ESteamResult)pParam->m_eResult, AcquireBuffer()};
+		if (pParam->m_eResult == k_EResultOK)
+		{
+			ReadResult.Data.SetNumUninitialized(pParam->m_cubRead);
+			if (!SteamRemoteStorage()->FileReadAsyncComplete(pParam->m_hFileReadAsync, ReadResult.Data.GetData(), pParam->m_cubRead))
+			{
+				ReadResult.Result = ESteamResult::Fail;
+				ReadResult.Data.Reset();
+			}
+		}
+		Promise.SetValue(MoveTemp(ReadResult));
+	}
+
 	m_OnRemoteStorageFileReadAsyncComplete.Broadcast(pParam->m_hFileReadAsync, (ESteamResult)pParam->m_eResult, pParam->m_nOffset, pParam->m_cubRead);
 }
 
@@ -62,6 +433,13 @@ void USteamRemoteStorage::OnRemoteStorageFileShareResult(RemoteStorageFileShareR
 
 void USteamRemoteStorage::OnRemoteStorageFileWriteAsyncComplete(RemoteStorageFileWriteAsyncComplete_t* pParam)
 {
+	// Writes made with WriteFileAsync refresh their own entry, the others don't say which file they wrote
+	if (m_NumUntrackedWrites > 0)
+	{
+		m_NumUntrackedWrites--;
+		m_bManifestValid = false;
+	}
+
 	m_OnRemoteStorageFileWriteAsyncComplete.Broadcast((ESteamResult)pParam->m_eResult);
 }
 
@@ -4,6 +4,19 @@
 
 #include "SteamBridgeUtils.h"
 
+namespace
+{
+	// Steam has no k_cch constants for these, the limits come from the ISteamUGC docs.
+	constexpr int32 SteamUGCKeyValueTagMax = 255 + 1;
+	constexpr int32 SteamUGCInstallFolderMax = 1024;
+
+	// Callers may pass 0 to use the SDK limit, anything larger than the limit is wasted space.
+	int32 ClampScratchSize(int32 RequestedSize, int32 SDKLimit)
+	{
+		return RequestedSize > 0 ? FMath::Min(RequestedSize, SDKLimit) : SDKLimit;
+	}
+}  // namespace
+
 USteamUGC::USteamUGC()
 {
 	OnAddAppDependencyResultCallback.Register(this, &USteamUGC::OnAddAppDependencyResult);
@@ -71,61 +84,75 @@ FUGCQueryHandle USteamUGC::CreateQueryUserUGCRequest(FAccountID AccountID, EStea
 
 bool USteamUGC::GetItemInstallInfo(FPublishedFileId PublishedFileID, int64& SizeOnDisk, FString& FolderName, int32 FolderSize, int32& TimeStamp) const
 {
-	TArray<char> TmpData;
-	TmpData.SetNum(FolderSize);
-	bool bResult = SteamUGC()->GetItemInstallInfo(PublishedFileID, (uint64*)&SizeOnDisk, TmpData.GetData(), TmpData.Num(), (uint32*)&TimeStamp);
-	FolderName = UTF8_TO_TCHAR(TmpData.GetData());
+	const int32 BufferSize = ClampScratchSize(FolderSize, SteamUGCInstallFolderMax);
+	char* TmpFolder = m_ScratchBuffer.Reserve(BufferSize);
+	bool bResult = SteamUGC()->GetItemInstallInfo(PublishedFileID, (uint64*)&SizeOnDisk, TmpFolder, BufferSize, (uint32*)&TimeStamp);
+	USteamBridgeUtils::ConvertUTF8ToString(TmpFolder, BufferSize, FolderName);
 	return bResult;
 }
 
 bool USteamUGC::GetQueryUGCAdditionalPreview(FUGCQueryHandle handle, int32 index, int32 previewIndex, FString& URLOrVideoID, int32 URLSize, FString& OriginalFileName, int32 OriginalFileNameSize, ESteamItemPreviewType& PreviewType) const
 {
-	TArray<char> TmpStr, TmpStr2;
-	TmpStr.SetNum(URLSize);
-	TmpStr2.SetNum(OriginalFileNameSize);
-	bool bResult = SteamUGC()->GetQueryUGCAdditionalPreview(handle, index, previewIndex, TmpStr.GetData(), TmpStr.Num(), TmpStr2.GetData(), TmpStr2.Num(), (EItemPreviewType*)&PreviewType);
-	URLOrVideoID = UTF8_TO_TCHAR(TmpStr.GetData());
-	OriginalFileName = UTF8_TO_TCHAR(TmpStr2.GetData());
+	const int32 TmpURLSize = ClampScratchSize(URLSize, k_cchPublishedFileURLMax);
+	const int32 TmpFileNameSize = ClampScratchSize(OriginalFileNameSize, k_cchFilenameMax);
+	char* TmpURL = m_ScratchBuffer.Reserve(TmpURLSize + TmpFileNameSize);
+	char* TmpFileName = TmpURL + TmpURLSize;
+	bool bResult = SteamUGC()->GetQueryUGCAdditionalPreview(handle, index, previewIndex, TmpURL, TmpURLSize, TmpFileName, TmpFileNameSize, (EItemPreviewType*)&PreviewType);
+	USteamBridgeUtils::ConvertUTF8ToString(TmpURL, TmpURLSize, URLOrVideoID);
+	USteamBridgeUtils::ConvertUTF8ToString(TmpFileName, TmpFileNameSize, OriginalFileName);
 	return bResult;
 }
 
 bool USteamUGC::GetQueryUGCChildren(FUGCQueryHandle handle, int32 index, TArray<FPublishedFileId>& PublishedFileIDs, int32 MaxEntries) const
 {
-	TArray<PublishedFileId_t> TmpData;
-	TmpData.SetNum(MaxEntries);
-	bool bResult = SteamUGC()->GetQueryUGCChildren(handle, index, TmpData.GetData(), TmpData.Num());
-	for (int32 i = 0; i < TmpData.Num(); i++)
+	static_assert(sizeof(FPublishedFileId) == sizeof(PublishedFileId_t), "FPublishedFileId must be layout compatible with PublishedFileId_t");
+
+	// Steam only writes as many IDs as the item has children, sizing the array to that leaves no uninitialized tail
+	SteamUGCDetails_t TmpDetails;
+	if (!SteamUGC()->GetQueryUGCResult(handle, index, &TmpDetails))
+	{
+		PublishedFileIDs.Reset();
+		return false;
+	}
+
+	const int32 NumChildren = TmpDetails.m_unNumChildren;
+	const int32 NumEntries = MaxEntries <= 0 ? NumChildren : FMath::Min(MaxEntries, NumChildren);
+	PublishedFileIDs.SetNumUninitialized(NumEntries, false);
+	bool bResult = SteamUGC()->GetQueryUGCChildren(handle, index, (PublishedFileId_t*)PublishedFileIDs.GetData(), NumEntries);
+	if (!bResult)
 	{
-		PublishedFileIDs.Add(TmpData[i]);
+		PublishedFileIDs.Reset();
 	}
 	return bResult;
 }
 
 bool USteamUGC::GetQueryUGCKeyValueTag(FUGCQueryHandle handle, int32 index, int32 keyValueTagIndex, FString& Key, int32 KeySize, FString& Value, int32 ValueSize) const
 {
-	TArray<char> TmpKey, TmpValue;
-	TmpKey.SetNum(KeySize);
-	TmpValue.SetNum(ValueSize);
-	bool bResult = SteamUGC()->GetQueryUGCKeyValueTag(handle, index, keyValueTagIndex, TmpKey.GetData(), TmpKey.Num(), TmpValue.GetData(), TmpValue.Num());
-	Key = UTF8_TO_TCHAR(TmpKey.GetData());
-	Value = UTF8_TO_TCHAR(TmpValue.GetData());
+	const int32 TmpKeySize = ClampScratchSize(KeySize, SteamUGCKeyValueTagMax);
+	const int32 TmpValueSize = ClampScratchSize(ValueSize, SteamUGCKeyValueTagMax);
+	char* TmpKey = m_ScratchBuffer.Reserve(TmpKeySize + TmpValueSize);
+	char* TmpValue = TmpKey + TmpKeySize;
+	bool bResult = SteamUGC()->GetQueryUGCKeyValueTag(handle, index, keyValueTagIndex, TmpKey, TmpKeySize, TmpValue, TmpValueSize);
+	USteamBridgeUtils::ConvertUTF8ToString(TmpKey, TmpKeySize, Key);
+	USteamBridgeUtils::ConvertUTF8ToString(TmpValue, TmpValueSize, Value);
 	return bResult;
 }
 
 bool USteamUGC::GetQueryUGCMetadata(FUGCQueryHandle handle, int32 index, FString& Metadata, int32 Metadatasize) const
 {
-	TArray<char> TmpStr;
-	bool bResult = SteamUGC()->GetQueryUGCMetadata(handle, index, TmpStr.GetData(), TmpStr.Num());
-	Metadata = UTF8_TO_TCHAR(TmpStr.GetData());
+	const int32 BufferSize = ClampScratchSize(Metadatasize, k_cchDeveloperMetadataMax);
+	char* TmpMetadata = m_ScratchBuffer.Reserve(BufferSize);
+	bool bResult = SteamUGC()->GetQueryUGCMetadata(handle, index, TmpMetadata, BufferSize);
+	USteamBridgeUtils::ConvertUTF8ToString(TmpMetadata, BufferSize, Metadata);
 	return bResult;
 }
 
 bool USteamUGC::GetQueryUGCPreviewURL(FUGCQueryHandle handle, int32 index, FString& URL, int32 URLSize) const
 {
-	TArray<char> TmpUrl;
-	TmpUrl.SetNum(URLSize);
-	bool bResult = SteamUGC()->GetQueryUGCPreviewURL(handle, index, TmpUrl.GetData(), TmpUrl.Num());
-	URL = UTF8_TO_TCHAR(TmpUrl.GetData());
+	const int32 BufferSize = ClampScratchSize(URLSize, k_cchPublishedFileURLMax);
+	char* TmpURL = m_ScratchBuffer.Reserve(BufferSize);
+	bool bResult = SteamUGC()->GetQueryUGCPreviewURL(handle, index, TmpURL, BufferSize);
+	USteamBridgeUtils::ConvertUTF8ToString(TmpURL, BufferSize, URL);
 	return bResult;
 }
 
@@ -139,13 +166,14 @@ bool USteamUGC::GetQueryUGCResult(FUGCQueryHandle handle, int32 index, FSteamUGC
 
 int32 USteamUGC::GetSubscribedItems(TArray<FPublishedFileId>& PublishedFileIDs, int32 MaxEntries) const
 {
-	TArray<PublishedFileId_t> TmpData;
-	int32 result = SteamUGC()->GetSubscribedItems(TmpData.GetData(), MaxEntries);
-	for (int32 i = 0; i < result; i++)
+	if (MaxEntries <= 0)
 	{
-		PublishedFileIDs.Add(TmpData[i]);
+		MaxEntries = SteamUGC()->GetNumSubscribedItems();
 	}
 
+	PublishedFileIDs.SetNumUninitialized(MaxEntries, false);
+	const int32 result = SteamUGC()->GetSubscribedItems((PublishedFileId_t*)PublishedFileIDs.GetData(), MaxEntries);
+	PublishedFileIDs.SetNum(FMath::Min(result, MaxEntries), false);
 	return result;
 }
 
@@ -0,0 +1,266 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamUGCContentPipeline.h"
+
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "Core/SteamUGC.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+namespace
+{
+	// FPakInfo::PakFile_Magic, stored little-endian in the pak footer
+	constexpr uint32 PakFileMagic = 0x5A6F12E1;
+
+	// The footer is a couple hundred bytes depending on the pak version, the magic always lives inside the last 512
+	constexpr int64 PakFooterSearchSize = 512;
+
+	constexpr int32 HashReadBufferSize = 1024 * 64;
+}  // namespace
+
+USteamUGCContentPipeline::USteamUGCContentPipeline() :
+	m_MaxParallelScans(4), m_PakMountOrder(4), m_Generation(0), m_bRunning(false)
+{
+}
+
+USteamUGCContentPipeline::~USteamUGCContentPipeline()
+{
+	if (m_TickHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(m_TickHandle);
+	}
+
+	// Running scans write into m_CompletedScans, don't let them outlive it
+	while (m_NumScansInFlight.GetValue() > 0)
+	{
+		FPlatformProcess::Sleep(0.001f);
+	}
+}
+
+void USteamUGCContentPipeline::StartPipeline(int32 MaxParallelScans, int32 PakMountOrder, bool bProcessInstalledItems)
+{
+	m_MaxParallelScans = FMath::Max(1, MaxParallelScans);
+	m_PakMountOrder = PakMountOrder;
+
+	if (!m_bRunning)
+	{
+		m_bRunning = true;
+		USteamUGC::GetSteamUGC()->m_OnItemInstalled.AddUniqueDynamic(this, &USteamUGCContentPipeline::HandleItemInstalled);
+		m_TickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USteamUGCContentPipeline::Tick));
+	}
+
+	if (bProcessInstalledItems)
+	{
+		TArray<FPublishedFileId> SubscribedItems;
+		USteamUGC::GetSteamUGC()->GetSubscribedItems(SubscribedItems, 0);
+
+		m_PendingItems.Reserve(m_PendingItems.Num() + SubscribedItems.Num());
+		for (const FPublishedFileId& PublishedFileID : SubscribedItems)
+		{
+			QueueItem(PublishedFileID);
+		}
+	}
+}
+
+void USteamUGCContentPipeline::StopPipeline()
+{
+	if (!m_bRunning)
+	{
+		return;
+	}
+
+	USteamUGC::GetSteamUGC()->m_OnItemInstalled.RemoveDynamic(this, &USteamUGCContentPipeline::HandleItemInstalled);
+
+	FTicker::GetCoreTicker().RemoveTicker(m_TickHandle);
+	m_TickHandle.Reset();
+
+	m_bRunning = false;
+	m_Generation++;
+	m_PendingItems.Reset();
+	m_QueuedItems.Reset();
+	m_CompletedScans.Empty();
+	m_MountBatch.Reset();
+}
+
+bool USteamUGCContentPipeline::QueueItem(FPublishedFileId PublishedFileID)
+{
+	if (!m_bRunning || m_QueuedItems.Contains(PublishedFileID))
+	{
+		return false;
+	}
+
+	int64 SizeOnDisk = 0;
+	int32 TimeStamp = 0;
+	FString InstallFolder;
+	if (!USteamUGC::GetSteamUGC()->GetItemInstallInfo(PublishedFileID, SizeOnDisk, InstallFolder, 0, TimeStamp))
+	{
+		return false;
+	}
+
+	FPaths::NormalizeDirectoryName(InstallFolder);
+	m_PendingItems.Emplace(PublishedFileID, InstallFolder);
+	m_QueuedItems.Add(PublishedFileID);
+	return true;
+}
+
+bool USteamUGCContentPipeline::Tick(float DeltaTime)
+{
+	MountCompletedScans();
+	LaunchScans();
+	return true;
+}
+
+void USteamUGCContentPipeline::LaunchScans()
+{
+	int32 NumToLaunch = FMath::Min(m_MaxParallelScans - m_NumScansInFlight.GetValue(), m_PendingItems.Num());
+	if (NumToLaunch <= 0)
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < NumToLaunch; i++)
+	{
+		m_NumScansInFlight.Increment();
+		Async(EAsyncExecution::TaskGraph, [this, Generation = m_Generation, Result = MoveTemp(m_PendingItems[i])]() mutable {
+			ScanContent(Result);
+			m_CompletedScans.Enqueue(TPair<uint32, FSteamUGCContentScanResult>(Generation, MoveTemp(Result)));
+			m_NumScansInFlight.Decrement();
+		});
+	}
+	m_PendingItems.RemoveAt(0, NumToLaunch, false);
+}
+
+void USteamUGCContentPipeline::MountCompletedScans()
+{
+	TPair<uint32, FSteamUGCContentScanResult> Completed;
+	while (m_CompletedScans.Dequeue(Completed))
+	{
+		if (Completed.Key == m_Generation)
+		{
+			m_QueuedItems.Remove(Completed.Value.PublishedFileID);
+			m_MountBatch.Add(MoveTemp(Completed.Value));
+		}
+	}
+
+	if (m_MountBatch.Num() == 0)
+	{
+		return;
+	}
+
+	// The pak platform file only binds OnMountPak when paks are in use (i.e. not in the editor), skip mounting when it isn't there
+	if (FCoreDelegates::OnMountPak.IsBound())
+	{
+		for (FSteamUGCContentScanResult& Result : m_MountBatch)
+		{
+			for (const FString& PakFile : Result.PakFiles)
+			{
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 26
+				const bool bMounted = FCoreDelegates::OnMountPak.Execute(PakFile, m_PakMountOrder) != nullptr;
+#else
+				const bool bMounted = FCoreDelegates::OnMountPak.Execute(PakFile, m_PakMountOrder, nullptr);
+#endif
+				if (bMounted)
+				{
+					Result.NumMountedPaks++;
+				}
+			}
+		}
+	}
+
+	m_OnContentMounted.Broadcast(m_MountBatch);
+	m_MountBatch.Reset();
+}
+
+void USteamUGCContentPipeline::ScanContent(FSteamUGCContentScanResult& Result)
+{
+	TArray<FString> Files;
+	IFileManager::Get().FindFilesRecursive(Files, *Result.InstallFolder, TEXT("*"), true, false, false);
+
+	// Directory enumeration order isn't stable across platforms, sort so the content hash is
+	Files.Sort();
+
+	FSHA1 ContentHash;
+	TArray<uint8> ReadBuffer;
+	ReadBuffer.SetNumUninitialized(HashReadBufferSize);
+
+	const int32 FolderPrefixLen = Result.InstallFolder.Len() + 1;
+	for (const FString& File : Files)
+	{
+		const FTCHARToUTF8 RelativePath(*File + FolderPrefixLen);
+		const FMD5Hash FileHash = FMD5Hash::HashFile(*File, &ReadBuffer);
+
+		ContentHash.Update((const uint8*)RelativePath.Get(), RelativePath.Length());
+		ContentHash.Update(FileHash.GetBytes(), FileHash.GetSize());
+
+		Result.NumFiles++;
+		Result.TotalBytes += FMath::Max<int64>(0, IFileManager::Get().FileSize(*File));
+
+		if (FPaths::GetExtension(File) == TEXT("pak"))
+		{
+			if (IsValidPakFile(File))
+			{
+				Result.PakFiles.Add(File);
+			}
+			else
+			{
+				Result.InvalidPakFiles.Add(File);
+			}
+		}
+	}
+
+	ContentHash.Final();
+	uint8 Digest[FSHA1::DigestSize];
+	ContentHash.GetHash(Digest);
+	Result.ContentHash = BytesToHex(Digest, FSHA1::DigestSize);
+}
+
+bool USteamUGCContentPipeline::IsValidPakFile(const FString& FileName)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FileName));
+	if (Reader == nullptr)
+	{
+		return false;
+	}
+
+	const int64 FileSize = Reader->TotalSize();
+	const int64 TailSize = FMath::Min(FileSize, PakFooterSearchSize);
+	if (TailSize < (int64)sizeof(uint32))
+	{
+		return false;
+	}
+
+	uint8 Tail[PakFooterSearchSize];
+	Reader->Seek(FileSize - TailSize);
+	Reader->Serialize(Tail, TailSize);
+	if (Reader->IsError())
+	{
+		return false;
+	}
+
+	for (int64 i = TailSize - sizeof(uint32); i >= 0; i--)
+	{
+		uint32 Magic;
+		FMemory::Memcpy(&Magic, Tail + i, sizeof(uint32));
+		if (Magic == PakFileMagic)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void USteamUGCContentPipeline::HandleItemInstalled(int32 AppID, FPublishedFileId PublishedFileID)
+{
+	if ((uint32)AppID != SteamUtils()->GetAppID())
+	{
+		return;
+	}
+
+	QueueItem(PublishedFileID);
+}
@@ -0,0 +1,315 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamUGCDownloader.h"
+
+#include "Containers/Ticker.h"
+
+namespace
+{
+	// Closes a file that was opened by UGCRead before the last byte was read
+	void CloseUGCFile(UGCHandle_t Handle, int32 Offset)
+	{
+		uint8 Unused;
+		SteamRemoteStorage()->UGCRead(Handle, &Unused, 0, (uint32)Offset, k_EUGCRead_Close);
+	}
+}  // namespace
+
+USteamUGCDownloader::USteamUGCDownloader() :
+	m_SinkHandle(k_UGCHandleInvalid), m_NextSequence(0), m_MaxConcurrentDownloads(4), m_MaxBytesInFlight(32 * 1024 * 1024), m_ReadBytesPerTick(1024 * 1024)
+{
+}
+
+USteamUGCDownloader::~USteamUGCDownloader()
+{
+	if (m_TickHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(m_TickHandle);
+	}
+}
+
+TFuture<FSteamCloudReadResult> USteamUGCDownloader::DownloadToMemory(FUGCHandle ContentHandle, int32 Priority)
+{
+	FDownload* const Download = AddDownload(ContentHandle, Priority);
+	if (Download == nullptr)
+	{
+		TPromise<FSteamCloudReadResult> Promise;
+		Promise.SetValue(FSteamCloudReadResult{ESteamResult::Busy, TArray<uint8>()});
+		return Promise.GetFuture();
+	}
+
+	Download->bToMemory = true;
+	return Download->MemoryPromise.Emplace().GetFuture();
+}
+
+TFuture<ESteamResult> USteamUGCDownloader::DownloadToSink(FUGCHandle ContentHandle, FSteamUGCSink&& Sink, int32 Priority)
+{
+	FDownload* const Download = AddDownload(ContentHandle, Priority);
+	if (Download == nullptr)
+	{
+		TPromise<ESteamResult> Promise;
+		Promise.SetValue(ESteamResult::Busy);
+		return Promise.GetFuture();
+	}
+
+	Download->bToMemory = false;
+	Download->Sink = MoveTemp(Sink);
+	return Download->SinkPromise.Emplace().GetFuture();
+}
+
+bool USteamUGCDownloader::CancelDownload(FUGCHandle ContentHandle)
+{
+	const TUniquePtr<FDownload>* const Download = m_Downloads.Find(ContentHandle);
+	if (Download == nullptr)
+	{
+		return false;
+	}
+
+	// The sink and the download it's reading can't be destroyed while the sink runs, ReadDownload finishes it once the sink returned
+	if (ContentHandle == m_SinkHandle)
+	{
+		(*Download)->bCancelled = true;
+		return true;
+	}
+
+	switch ((*Download)->State)
+	{
+		case EDownloadState::Queued:
+			m_DownloadQueue.RemoveAll([&](const FQueuedDownload& Queued) { return Queued.Handle == ContentHandle; });
+			m_DownloadQueue.Heapify();
+			break;
+		case EDownloadState::Reading:
+			CloseUGCFile(ContentHandle, (*Download)->Offset);
+			break;
+		default:
+			// UGCDownload can't be cancelled, its result is ignored once the download is forgotten
+			break;
+	}
+
+	FinishDownload(ContentHandle, ESteamResult::Cancelled);
+	return true;
+}
+
+bool USteamUGCDownloader::GetDownloadProgress(FUGCHandle ContentHandle, int32& BytesDone, int32& BytesExpected, bool& bReading) const
+{
+	const TUniquePtr<FDownload>* const Download = m_Downloads.Find(ContentHandle);
+	if (Download == nullptr)
+	{
+		return false;
+	}
+
+	BytesDone = 0;
+	BytesExpected = 0;
+	bReading = (*Download)->State == EDownloadState::Reading;
+	if (bReading)
+	{
+		BytesDone = (*Download)->Offset;
+		BytesExpected = (*Download)->Size;
+	}
+	else if ((*Download)->State == EDownloadState::Downloading)
+	{
+		SteamRemoteStorage()->GetUGCDownloadProgress(ContentHandle, &BytesDone, &BytesExpected);
+	}
+	return true;
+}
+
+USteamUGCDownloader::FDownload* USteamUGCDownloader::AddDownload(UGCHandle_t Handle, int32 Priority)
+{
+	if (Handle == k_UGCHandleInvalid || m_Downloads.Contains(Handle))
+	{
+		return nullptr;
+	}
+
+	TUniquePtr<FDownload> Download = MakeUnique<FDownload>();
+	Download->State = EDownloadState::Queued;
+	Download->Size = 0;
+	Download->Offset = 0;
+	Download->bToMemory = false;
+	Download->bCancelled = false;
+	m_DownloadQueue.HeapPush(FQueuedDownload{Handle, Priority, m_NextSequence++});
+
+	if (!m_TickHandle.IsValid())
+	{
+		USteamRemoteStorage::GetSteamRemoteStorage()->m_OnRemoteStorageDownloadUGCResult.AddUniqueDynamic(this, &USteamUGCDownloader::HandleDownloadUGCResult);
+		m_TickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USteamUGCDownloader::Tick));
+	}
+
+	return m_Downloads.Add(Handle, MoveTemp(Download)).Get();
+}
+
+void USteamUGCDownloader::FinishDownload(UGCHandle_t Handle, ESteamResult Result)
+{
+	TUniquePtr<FDownload> Download;
+	if (!m_Downloads.RemoveAndCopyValue(Handle, Download))
+	{
+		return;
+	}
+
+	if (Download->bToMemory)
+	{
+		if (Result != ESteamResult::OK)
+		{
+			Download->Data.Empty();
+		}
+		Download->MemoryPromise->SetValue(FSteamCloudReadResult{Result, MoveTemp(Download->Data)});
+	}
+	else
+	{
+		Download->SinkPromise->SetValue(Result);
+	}
+}
+
+bool USteamUGCDownloader::Tick(float DeltaTime)
+{
+	// Sinks may start or cancel downloads, so the map isn't iterated while they run
+	TArray<UGCHandle_t, TInlineAllocator<8>> Reading;
+	for (const TPair<UGCHandle_t, TUniquePtr<FDownload>>& Entry : m_Downloads)
+	{
+		if (Entry.Value->State == EDownloadState::Reading)
+		{
+			Reading.Add(Entry.Key);
+		}
+	}
+
+	// The read budget is shared by every finished download so a frame never reads more than m_ReadBytesPerTick
+	int32 ReadBudget = m_ReadBytesPerTick;
+	for (UGCHandle_t Handle : Reading)
+	{
+		const TUniquePtr<FDownload>* const Download = m_Downloads.Find(Handle);
+		if (Download == nullptr || (*Download)->State != EDownloadState::Reading || ReadBudget <= 0)
+		{
+			continue;
+		}
+
+		ESteamResult Result = ESteamResult::OK;
+		if (ReadDownload(Handle, **Download, ReadBudget, Result))
+		{
+			FinishDownload(Handle, Result);
+		}
+	}
+
+	PumpDownloadQueue();
+
+	if (m_Downloads.Num() == 0)
+	{
+		m_TickHandle.Reset();
+		return false;
+	}
+	return true;
+}
+
+void USteamUGCDownloader::PumpDownloadQueue()
+{
+	if (m_DownloadQueue.Num() == 0)
+	{
+		return;
+	}
+
+	// Bytes the running downloads still have to receive, files Steam doesn't know the size of yet count as nothing
+	int32 NumActive = 0;
+	int64 BytesInFlight = 0;
+	for (const TPair<UGCHandle_t, TUniquePtr<FDownload>>& Entry : m_Downloads)
+	{
+		if (Entry.Value->State == EDownloadState::Downloading)
+		{
+			int32 BytesDownloaded = 0, BytesExpected = 0;
+			if (SteamRemoteStorage()->GetUGCDownloadProgress(Entry.Key, &BytesDownloaded, &BytesExpected))
+			{
+				BytesInFlight += FMath::Max(0, BytesExpected - BytesDownloaded);
+			}
+		}
+
+		NumActive += Entry.Value->State != EDownloadState::Queued ? 1 : 0;
+	}
+
+	while (m_DownloadQueue.Num() > 0 && NumActive < m_MaxConcurrentDownloads && (NumActive == 0 || BytesInFlight < m_MaxBytesInFlight))
+	{
+		FQueuedDownload Queued;
+		m_DownloadQueue.HeapPop(Queued, false);
+
+		if (SteamRemoteStorage()->UGCDownload(Queued.Handle, 0) == k_uAPICallInvalid)
+		{
+			FinishDownload(Queued.Handle, ESteamResult::Fail);
+			continue;
+		}
+
+		m_Downloads[Queued.Handle]->State = EDownloadState::Downloading;
+		NumActive++;
+	}
+}
+
+bool USteamUGCDownloader::ReadDownload(UGCHandle_t Handle, FDownload& Download, int32& ReadBudget, ESteamResult& Result)
+{
+	while (Download.Offset < Download.Size && ReadBudget > 0)
+	{
+		const int32 BytesToRead = FMath::Min(Download.Size - Download.Offset, ReadBudget);
+
+		// Memory downloads are read straight into their final buffer, sinks get a slice of the shared one
+		uint8* Dest;
+		if (Download.bToMemory)
+		{
+			Dest = Download.Data.GetData() + Download.Offset;
+		}
+		else
+		{
+			m_ReadBuffer.SetNumUninitialized(BytesToRead, false);
+			Dest = m_ReadBuffer.GetData();
+		}
+
+		const int32 BytesRead = SteamRemoteStorage()->UGCRead(Handle, Dest, BytesToRead, (uint32)Download.Offset, k_EUGCRead_ContinueReadingUntilFinished);
+		if (BytesRead <= 0)
+		{
+			CloseUGCFile(Handle, Download.Offset);
+			Result = ESteamResult::IOFailure;
+			return true;
+		}
+
+		bool bKeepReading = true;
+		if (!Download.bToMemory)
+		{
+			m_SinkHandle = Handle;
+			bKeepReading = Download.Sink(MakeArrayView(Dest, BytesRead)) && !Download.bCancelled;
+			m_SinkHandle = k_UGCHandleInvalid;
+		}
+
+		if (!bKeepReading)
+		{
+			CloseUGCFile(Handle, Download.Offset + BytesRead);
+			Result = ESteamResult::Cancelled;
+			return true;
+		}
+
+		Download.Offset += BytesRead;
+		ReadBudget -= BytesRead;
+	}
+
+	Result = ESteamResult::OK;
+	return Download.Offset >= Download.Size;
+}
+
+void USteamUGCDownloader::HandleDownloadUGCResult(ESteamResult Result, FUGCHandle FileHandle, int32 AppID, int32 SizeInBytes, FString FileName, FSteamID SteamIDOwner)
+{
+	const TUniquePtr<FDownload>* const Download = m_Downloads.Find(FileHandle);
+	if (Download == nullptr || (*Download)->State != EDownloadState::Downloading)
+	{
+		return;
+	}
+
+	if (Result != ESteamResult::OK)
+	{
+		FinishDownload(FileHandle, Result);
+		return;
+	}
+
+	(*Download)->State = EDownloadState::Reading;
+	(*Download)->Size = FMath::Max(0, SizeInBytes);
+	(*Download)->Offset = 0;
+	if ((*Download)->bToMemory)
+	{
+		(*Download)->Data.SetNumUninitialized((*Download)->Size);
+	}
+
+	if ((*Download)->Size == 0)
+	{
+		FinishDownload(FileHandle, ESteamResult::OK);
+	}
+}
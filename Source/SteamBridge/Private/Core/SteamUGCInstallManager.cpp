@@ -0,0 +1,376 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamUGCInstallManager.h"
+
+#include "Containers/Ticker.h"
+#include "Core/SteamRemoteStorage.h"
+#include "Core/SteamUGC.h"
+
+USteamUGCInstallManager::USteamUGCInstallManager() :
+	m_NextSequence(0), m_MaxConcurrentDownloads(4), m_bTracking(false), m_bGameplayActive(false), m_bSuspendDuringGameplay(true), m_bDownloadsSuspended(false)
+{
+}
+
+USteamUGCInstallManager::~USteamUGCInstallManager()
+{
+	if (m_TickHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(m_TickHandle);
+	}
+}
+
+void USteamUGCInstallManager::StartTracking(int32 MaxConcurrentDownloads)
+{
+	m_MaxConcurrentDownloads = FMath::Max(1, MaxConcurrentDownloads);
+
+	if (!m_bTracking)
+	{
+		m_bTracking = true;
+
+		USteamUGC* const UGC = USteamUGC::GetSteamUGC();
+		UGC->m_OnItemInstalled.AddUniqueDynamic(this, &USteamUGCInstallManager::HandleItemInstalled);
+		UGC->m_OnDownloadItemResult.AddUniqueDynamic(this, &USteamUGCInstallManager::HandleDownloadItemResult);
+
+		USteamRemoteStorage* const RemoteStorage = USteamRemoteStorage::GetSteamRemoteStorage();
+		RemoteStorage->m_OnRemoteStoragePublishedFileSubscribed.AddUniqueDynamic(this, &USteamUGCInstallManager::HandlePublishedFileSubscribed);
+		RemoteStorage->m_OnRemoteStoragePublishedFileUnsubscribed.AddUniqueDynamic(this, &USteamUGCInstallManager::HandlePublishedFileUnsubscribed);
+
+		m_TickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USteamUGCInstallManager::Tick));
+	}
+
+	RefreshSubscribedItems();
+	ApplySuspendState();
+}
+
+void USteamUGCInstallManager::StopTracking()
+{
+	if (!m_bTracking)
+	{
+		return;
+	}
+
+	USteamUGC* const UGC = USteamUGC::GetSteamUGC();
+	UGC->m_OnItemInstalled.RemoveDynamic(this, &USteamUGCInstallManager::HandleItemInstalled);
+	UGC->m_OnDownloadItemResult.RemoveDynamic(this, &USteamUGCInstallManager::HandleDownloadItemResult);
+
+	USteamRemoteStorage* const RemoteStorage = USteamRemoteStorage::GetSteamRemoteStorage();
+	RemoteStorage->m_OnRemoteStoragePublishedFileSubscribed.RemoveDynamic(this, &USteamUGCInstallManager::HandlePublishedFileSubscribed);
+	RemoteStorage->m_OnRemoteStoragePublishedFileUnsubscribed.RemoveDynamic(this, &USteamUGCInstallManager::HandlePublishedFileUnsubscribed);
+
+	FTicker::GetCoreTicker().RemoveTicker(m_TickHandle);
+	m_TickHandle.Reset();
+
+	m_bTracking = false;
+	ApplySuspendState();
+
+	m_Entries.Reset();
+	m_EntryIndices.Reset();
+	m_DownloadQueue.Reset();
+	m_ActiveDownloads.Reset();
+}
+
+void USteamUGCInstallManager::RefreshSubscribedItems()
+{
+	TArray<FPublishedFileId> SubscribedItems;
+	USteamUGC::GetSteamUGC()->GetSubscribedItems(SubscribedItems, 0);
+
+	TSet<uint64> Subscribed;
+	Subscribed.Reserve(SubscribedItems.Num());
+	for (const FPublishedFileId& PublishedFileID : SubscribedItems)
+	{
+		Subscribed.Add(PublishedFileID);
+	}
+
+	for (int32 i = m_Entries.Num() - 1; i >= 0; i--)
+	{
+		if (!Subscribed.Contains(m_Entries[i].PublishedFileID))
+		{
+			RemoveEntry(m_Entries[i].PublishedFileID);
+		}
+	}
+
+	m_Entries.Reserve(SubscribedItems.Num());
+	for (const FPublishedFileId& PublishedFileID : SubscribedItems)
+	{
+		FSteamUGCInstallEntry& Entry = FindOrAddEntry(PublishedFileID);
+		if (RefreshEntry(Entry))
+		{
+			m_OnInstallEntryChanged.Broadcast(Entry);
+		}
+		EnqueueIfNeeded(Entry);
+	}
+
+	PumpDownloadQueue();
+}
+
+void USteamUGCInstallManager::RequestDownload(FPublishedFileId PublishedFileID, int32 Priority, bool bHighPriority)
+{
+	FSteamUGCInstallEntry& Entry = FindOrAddEntry(PublishedFileID);
+	Entry.Priority = Priority;
+
+	if (m_ActiveDownloads.Contains(PublishedFileID))
+	{
+		return;
+	}
+
+	FQueuedDownload* const Queued = m_DownloadQueue.FindByPredicate([&](const FQueuedDownload& Download) { return Download.PublishedFileID == PublishedFileID; });
+	if (Queued != nullptr)
+	{
+		Queued->Priority = Priority;
+		Queued->bHighPriority |= bHighPriority;
+		m_DownloadQueue.Heapify();
+	}
+	else
+	{
+		m_DownloadQueue.HeapPush(FQueuedDownload{PublishedFileID, Priority, m_NextSequence++, bHighPriority});
+	}
+
+	PumpDownloadQueue();
+}
+
+void USteamUGCInstallManager::SetGameplayActive(bool bActive)
+{
+	m_bGameplayActive = bActive;
+	ApplySuspendState();
+	PumpDownloadQueue();
+}
+
+void USteamUGCInstallManager::SetSuspendDuringGameplay(bool bSuspend)
+{
+	m_bSuspendDuringGameplay = bSuspend;
+	ApplySuspendState();
+	PumpDownloadQueue();
+}
+
+void USteamUGCInstallManager::SetMaxConcurrentDownloads(int32 MaxConcurrentDownloads)
+{
+	m_MaxConcurrentDownloads = FMath::Max(1, MaxConcurrentDownloads);
+	PumpDownloadQueue();
+}
+
+bool USteamUGCInstallManager::GetInstallEntry(FPublishedFileId PublishedFileID, FSteamUGCInstallEntry& Entry) const
+{
+	if (const int32* Index = m_EntryIndices.Find(PublishedFileID))
+	{
+		Entry = m_Entries[*Index];
+		return true;
+	}
+	return false;
+}
+
+bool USteamUGCInstallManager::Tick(float DeltaTime)
+{
+	if (!m_bDownloadsSuspended)
+	{
+		PollActiveDownloads();
+		PumpDownloadQueue();
+	}
+	return true;
+}
+
+void USteamUGCInstallManager::PollActiveDownloads()
+{
+	TArray<uint64, TInlineAllocator<16>> ChangedIDs;
+	for (const uint64 PublishedFileID : m_ActiveDownloads)
+	{
+		const int32* Index = m_EntryIndices.Find(PublishedFileID);
+		if (Index == nullptr)
+		{
+			continue;
+		}
+
+		FSteamUGCInstallEntry& Entry = m_Entries[*Index];
+		uint64 BytesDownloaded = 0, BytesTotal = 0;
+		const int32 NewState = SteamUGC()->GetItemState(PublishedFileID);
+		SteamUGC()->GetItemDownloadInfo(PublishedFileID, &BytesDownloaded, &BytesTotal);
+
+		if (NewState != Entry.ItemState || (int64)BytesDownloaded != Entry.BytesDownloaded || (int64)BytesTotal != Entry.BytesTotal)
+		{
+			Entry.ItemState = NewState;
+			Entry.BytesDownloaded = BytesDownloaded;
+			Entry.BytesTotal = BytesTotal;
+			ChangedIDs.Add(PublishedFileID);
+		}
+	}
+
+	// Broadcast after the loop, listeners may request downloads or stop tracking which changes the set and the entries
+	for (const uint64 PublishedFileID : ChangedIDs)
+	{
+		const int32* Index = m_EntryIndices.Find(PublishedFileID);
+		if (Index != nullptr)
+		{
+			const FSteamUGCInstallEntry Entry = m_Entries[*Index];
+			m_OnInstallEntryChanged.Broadcast(Entry);
+		}
+	}
+}
+
+void USteamUGCInstallManager::PumpDownloadQueue()
+{
+	if (!m_bTracking || (m_bGameplayActive && m_bSuspendDuringGameplay))
+	{
+		return;
+	}
+
+	while (m_ActiveDownloads.Num() < m_MaxConcurrentDownloads && m_DownloadQueue.Num() > 0)
+	{
+		FQueuedDownload Download;
+		m_DownloadQueue.HeapPop(Download, false);
+
+		const int32* Index = m_EntryIndices.Find(Download.PublishedFileID);
+		if (Index == nullptr || m_ActiveDownloads.Contains(Download.PublishedFileID))
+		{
+			continue;
+		}
+
+		if (SteamUGC()->DownloadItem(Download.PublishedFileID, Download.bHighPriority))
+		{
+			m_ActiveDownloads.Add(Download.PublishedFileID);
+		}
+		else
+		{
+			FSteamUGCInstallEntry& Entry = m_Entries[*Index];
+			Entry.LastResult = ESteamResult::Fail;
+			m_OnInstallEntryChanged.Broadcast(Entry);
+		}
+	}
+}
+
+void USteamUGCInstallManager::ApplySuspendState()
+{
+	const bool bShouldSuspend = m_bTracking && m_bGameplayActive && m_bSuspendDuringGameplay;
+	if (bShouldSuspend != m_bDownloadsSuspended)
+	{
+		m_bDownloadsSuspended = bShouldSuspend;
+		USteamUGC::GetSteamUGC()->SuspendDownloads(bShouldSuspend);
+	}
+}
+
+FSteamUGCInstallEntry& USteamUGCInstallManager::FindOrAddEntry(uint64 PublishedFileID)
+{
+	if (const int32* Index = m_EntryIndices.Find(PublishedFileID))
+	{
+		return m_Entries[*Index];
+	}
+
+	const int32 NewIndex = m_Entries.Emplace(PublishedFileID);
+	m_EntryIndices.Add(PublishedFileID, NewIndex);
+	return m_Entries[NewIndex];
+}
+
+void USteamUGCInstallManager::RemoveEntry(uint64 PublishedFileID)
+{
+	int32 Index = INDEX_NONE;
+	if (!m_EntryIndices.RemoveAndCopyValue(PublishedFileID, Index))
+	{
+		return;
+	}
+
+	m_Entries.RemoveAtSwap(Index, 1, false);
+	if (m_Entries.IsValidIndex(Index))
+	{
+		m_EntryIndices[m_Entries[Index].PublishedFileID] = Index;
+	}
+	m_ActiveDownloads.Remove(PublishedFileID);
+}
+
+bool USteamUGCInstallManager::RefreshEntry(FSteamUGCInstallEntry& Entry)
+{
+	const int32 NewState = SteamUGC()->GetItemState(Entry.PublishedFileID);
+	bool bChanged = NewState != Entry.ItemState;
+	Entry.ItemState = NewState;
+
+	if ((NewState & k_EItemStateInstalled) != 0)
+	{
+		int64 SizeOnDisk = 0;
+		int32 TimeStamp = 0;
+		if (USteamUGC::GetSteamUGC()->GetItemInstallInfo(Entry.PublishedFileID, SizeOnDisk, Entry.InstallFolder, 0, TimeStamp))
+		{
+			bChanged |= SizeOnDisk != Entry.SizeOnDisk || TimeStamp != Entry.TimeStamp;
+			Entry.SizeOnDisk = SizeOnDisk;
+			Entry.TimeStamp = TimeStamp;
+		}
+	}
+
+	return bChanged;
+}
+
+void USteamUGCInstallManager::EnqueueIfNeeded(const FSteamUGCInstallEntry& Entry)
+{
+	const bool bNeedsDownload = (Entry.ItemState & (k_EItemStateInstalled | k_EItemStateNeedsUpdate)) != k_EItemStateInstalled;
+	const bool bInProgress = (Entry.ItemState & (k_EItemStateDownloading | k_EItemStateDownloadPending)) != 0;
+	if (bNeedsDownload && !bInProgress && !m_ActiveDownloads.Contains(Entry.PublishedFileID))
+	{
+		if (!m_DownloadQueue.ContainsByPredicate([&](const FQueuedDownload& Download) { return Download.PublishedFileID == Entry.PublishedFileID; }))
+		{
+			m_DownloadQueue.HeapPush(FQueuedDownload{Entry.PublishedFileID, Entry.Priority, m_NextSequence++, false});
+		}
+	}
+	else if (bInProgress)
+	{
+		// Steam is already downloading it (e.g. auto-update), track the progress without issuing another DownloadItem
+		m_ActiveDownloads.Add(Entry.PublishedFileID);
+	}
+}
+
+void USteamUGCInstallManager::HandleItemInstalled(int32 AppID, FPublishedFileId PublishedFileID)
+{
+	if ((uint32)AppID != SteamUtils()->GetAppID())
+	{
+		return;
+	}
+
+	m_ActiveDownloads.Remove(PublishedFileID);
+	if (const int32* Index = m_EntryIndices.Find(PublishedFileID))
+	{
+		FSteamUGCInstallEntry& Entry = m_Entries[*Index];
+		RefreshEntry(Entry);
+		Entry.BytesDownloaded = Entry.BytesTotal;
+		m_OnInstallEntryChanged.Broadcast(Entry);
+	}
+
+	PumpDownloadQueue();
+}
+
+void USteamUGCInstallManager::HandleDownloadItemResult(int32 AppID, FPublishedFileId PublishedFileID, ESteamResult Result)
+{
+	if ((uint32)AppID != SteamUtils()->GetAppID())
+	{
+		return;
+	}
+
+	m_ActiveDownloads.Remove(PublishedFileID);
+	if (const int32* Index = m_EntryIndices.Find(PublishedFileID))
+	{
+		FSteamUGCInstallEntry& Entry = m_Entries[*Index];
+		Entry.LastResult = Result;
+		RefreshEntry(Entry);
+		m_OnInstallEntryChanged.Broadcast(Entry);
+	}
+
+	PumpDownloadQueue();
+}
+
+void USteamUGCInstallManager::HandlePublishedFileSubscribed(FPublishedFileId PublishedFileID, int32 AppID)
+{
+	if ((uint32)AppID != SteamUtils()->GetAppID())
+	{
+		return;
+	}
+
+	FSteamUGCInstallEntry& Entry = FindOrAddEntry(PublishedFileID);
+	RefreshEntry(Entry);
+	m_OnInstallEntryChanged.Broadcast(Entry);
+	EnqueueIfNeeded(Entry);
+	PumpDownloadQueue();
+}
+
+void USteamUGCInstallManager::HandlePublishedFileUnsubscribed(FPublishedFileId PublishedFileID, int32 AppID)
+{
+	if ((uint32)AppID != SteamUtils()->GetAppID())
+	{
+		return;
+	}
+
+	RemoveEntry(PublishedFileID);
+}
@@ -0,0 +1,319 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#include "Core/SteamUGCUploader.h"
+
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "Core/SteamUGC.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <windows.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+#elif PLATFORM_LINUX
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// Stage the job being submitted and the one after it, so the next upload can start as soon as the current one finishes
+	constexpr int32 MaxStagedJobs = 2;
+}  // namespace
+
+USteamUGCUploader::USteamUGCUploader() :
+	m_UpdateHandle(k_UGCUpdateHandleInvalid), m_SubmitStartTime(0.0), m_LastPollTime(0.0), m_bSubmitting(false), m_TotalBytesUploaded(0), m_TotalUploadSeconds(0.0), m_ProgressPollInterval(0.5f)
+{
+}
+
+USteamUGCUploader::~USteamUGCUploader()
+{
+	if (m_TickHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(m_TickHandle);
+	}
+
+	for (FUploadJob& Job : m_Jobs)
+	{
+		if (Job.Staging.IsValid())
+		{
+			Job.Staging.Wait();
+		}
+	}
+}
+
+bool USteamUGCUploader::QueueUpload(const FSteamUGCItemUpload& Upload)
+{
+	if (m_Jobs.ContainsByPredicate([&](const FUploadJob& Job) { return Job.Upload.PublishedFileID == Upload.PublishedFileID; }))
+	{
+		return false;
+	}
+
+	FUploadJob& Job = m_Jobs.AddDefaulted_GetRef();
+	Job.Upload = Upload;
+	Job.Upload.ContentFolder = FPaths::ConvertRelativePathToFull(Upload.ContentFolder);
+	FPaths::NormalizeDirectoryName(Job.Upload.ContentFolder);
+	if (!Upload.PreviewFile.IsEmpty())
+	{
+		Job.Upload.PreviewFile = FPaths::ConvertRelativePathToFull(Upload.PreviewFile);
+	}
+	Job.StagingFolder = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("SteamBridge/UGCStaging") / LexToString((uint64)Upload.PublishedFileID));
+
+	if (!m_TickHandle.IsValid())
+	{
+		m_TickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USteamUGCUploader::Tick), m_ProgressPollInterval);
+	}
+
+	LaunchStaging();
+	return true;
+}
+
+bool USteamUGCUploader::CancelUpload(FPublishedFileId PublishedFileID)
+{
+	const int32 Index = m_Jobs.IndexOfByPredicate([&](const FUploadJob& Job) { return Job.Upload.PublishedFileID == PublishedFileID; });
+	if (Index == INDEX_NONE || (Index == 0 && m_bSubmitting))
+	{
+		return false;
+	}
+
+	// Let a running staging task finish so a later upload of the same item doesn't stage into the folder at the same time
+	if (m_Jobs[Index].Staging.IsValid())
+	{
+		m_Jobs[Index].Staging.Wait();
+	}
+
+	IFileManager::Get().DeleteDirectory(*m_Jobs[Index].StagingFolder, false, true);
+	m_Jobs.RemoveAt(Index);
+	return true;
+}
+
+void USteamUGCUploader::SetProgressPollInterval(float Seconds)
+{
+	m_ProgressPollInterval = FMath::Max(0.0f, Seconds);
+
+	if (m_TickHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(m_TickHandle);
+		m_TickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USteamUGCUploader::Tick), m_ProgressPollInterval);
+	}
+}
+
+bool USteamUGCUploader::GetCurrentProgress(FSteamUGCUploadProgress& Progress) const
+{
+	if (!m_bSubmitting)
+	{
+		return false;
+	}
+
+	Progress = m_Progress;
+	return true;
+}
+
+bool USteamUGCUploader::Tick(float DeltaTime)
+{
+	if (m_bSubmitting)
+	{
+		PollProgress();
+	}
+	else
+	{
+		TrySubmitNext();
+	}
+
+	LaunchStaging();
+
+	if (!m_bSubmitting && m_Jobs.Num() == 0)
+	{
+		// Returning false removes the ticker, it's added again by the next QueueUpload
+		m_TickHandle.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+void USteamUGCUploader::PollProgress()
+{
+	uint64 BytesProcessed = 0, BytesTotal = 0;
+	const EItemUpdateStatus Status = SteamUGC()->GetItemUpdateProgress(m_UpdateHandle, &BytesProcessed, &BytesTotal);
+
+	const double Now = FPlatformTime::Seconds();
+	const double Elapsed = Now - m_LastPollTime;
+	m_LastPollTime = Now;
+
+	// BytesProcessed starts over for every status, only measure the rate within one
+	const bool bSameStatus = (ESteamItemUpdateStatus)Status == m_Progress.Status;
+	m_Progress.BytesPerSecond = bSameStatus && Elapsed > 0.0 && (int64)BytesProcessed >= m_Progress.BytesProcessed ? (float)(((int64)BytesProcessed - m_Progress.BytesProcessed) / Elapsed) : 0.0f;
+	m_Progress.Status = (ESteamItemUpdateStatus)Status;
+	m_Progress.BytesProcessed = BytesProcessed;
+	m_Progress.BytesTotal = BytesTotal;
+
+	m_OnUploadProgress.Broadcast(m_Progress);
+}
+
+void USteamUGCUploader::LaunchStaging()
+{
+	for (int32 i = 0; i < FMath::Min(m_Jobs.Num(), MaxStagedJobs); i++)
+	{
+		FUploadJob& Job = m_Jobs[i];
+		if (!Job.Staging.IsValid())
+		{
+			Job.Staging = Async(EAsyncExecution::TaskGraph, [SourceFolder = Job.Upload.ContentFolder, StagingFolder = Job.StagingFolder]() {
+				return StageContent(SourceFolder, StagingFolder);
+			});
+		}
+	}
+}
+
+bool USteamUGCUploader::TrySubmitNext()
+{
+	while (!m_bSubmitting && m_Jobs.Num() > 0)
+	{
+		const FUploadJob& Job = m_Jobs[0];
+		if (!Job.Staging.IsValid() || !Job.Staging.IsReady())
+		{
+			return false;
+		}
+
+		if (!Job.Staging.Get().bSucceeded)
+		{
+			CompleteCurrentJob(ESteamResult::FileNotFound, false);
+			continue;
+		}
+
+		USteamUGC* const UGC = USteamUGC::GetSteamUGC();
+		m_UpdateHandle = UGC->StartItemUpdate(SteamUtils()->GetAppID(), Job.Upload.PublishedFileID);
+		if (m_UpdateHandle == k_UGCUpdateHandleInvalid || !UGC->SetItemContent(m_UpdateHandle, Job.StagingFolder) || (!Job.Upload.PreviewFile.IsEmpty() && !UGC->SetItemPreview(m_UpdateHandle, Job.Upload.PreviewFile)))
+		{
+			CompleteCurrentJob(ESteamResult::InvalidParam, false);
+			continue;
+		}
+
+		const SteamAPICall_t Call = UGC->SubmitItemUpdate(m_UpdateHandle, Job.Upload.ChangeNote);
+		if (Call == k_uAPICallInvalid)
+		{
+			CompleteCurrentJob(ESteamResult::Fail, false);
+			continue;
+		}
+
+		m_SubmitCallResult.Set(Call, this, &USteamUGCUploader::OnSubmitItemUpdateResult);
+		m_bSubmitting = true;
+		m_Progress = FSteamUGCUploadProgress(Job.Upload.PublishedFileID);
+		m_SubmitStartTime = m_LastPollTime = FPlatformTime::Seconds();
+		return true;
+	}
+
+	return false;
+}
+
+void USteamUGCUploader::CompleteCurrentJob(ESteamResult Result, bool bUserNeedsToAcceptWorkshopLegalAgreement)
+{
+	const FUploadJob Job = MoveTemp(m_Jobs[0]);
+	m_Jobs.RemoveAt(0);
+
+	if (m_bSubmitting && Result == ESteamResult::OK)
+	{
+		m_TotalBytesUploaded += m_Progress.BytesTotal;
+		m_TotalUploadSeconds += FPlatformTime::Seconds() - m_SubmitStartTime;
+	}
+
+	m_bSubmitting = false;
+	m_UpdateHandle = k_UGCUpdateHandleInvalid;
+
+	// Jobs only complete after their staging task finished, so nothing writes to the folder anymore
+	IFileManager::Get().DeleteDirectory(*Job.StagingFolder, false, true);
+
+	m_OnUploadCompleted.Broadcast(Job.Upload.PublishedFileID, Result, bUserNeedsToAcceptWorkshopLegalAgreement, Job.Staging.IsValid() ? Job.Staging.Get() : FSteamUGCStagingStats());
+}
+
+FSteamUGCStagingStats USteamUGCUploader::StageContent(const FString& SourceFolder, const FString& StagingFolder)
+{
+	FSteamUGCStagingStats Stats;
+	IFileManager& FileManager = IFileManager::Get();
+	if (!FileManager.DirectoryExists(*SourceFolder))
+	{
+		return Stats;
+	}
+
+	TArray<FString> SourceFiles;
+	FileManager.FindFilesRecursive(SourceFiles, *SourceFolder, TEXT("*"), true, false, false);
+
+	TSet<FString> StagedFiles;
+	StagedFiles.Reserve(SourceFiles.Num());
+
+	const int32 SourcePrefixLen = SourceFolder.Len() + 1;
+	for (const FString& Source : SourceFiles)
+	{
+		const FString Dest = StagingFolder / Source.RightChop(SourcePrefixLen);
+		StagedFiles.Add(Dest);
+
+		// A hard link shares its stat data with the source and a copy gets the source's timestamp, so either one matches when it's up to date
+		const FFileStatData SourceStat = FileManager.GetStatData(*Source);
+		const FFileStatData DestStat = FileManager.GetStatData(*Dest);
+		if (DestStat.bIsValid)
+		{
+			if (DestStat.FileSize == SourceStat.FileSize && DestStat.ModificationTime == SourceStat.ModificationTime)
+			{
+				Stats.FilesSkipped++;
+				continue;
+			}
+			FileManager.Delete(*Dest, false, true, true);
+		}
+
+		FileManager.MakeDirectory(*FPaths::GetPath(Dest), true);
+		if (LinkStagedFile(Source, Dest))
+		{
+			Stats.FilesLinked++;
+		}
+		else if (FileManager.Copy(*Dest, *Source) == COPY_OK)
+		{
+			FileManager.SetTimeStamp(*Dest, SourceStat.ModificationTime);
+			Stats.FilesCopied++;
+			Stats.BytesCopied += SourceStat.FileSize;
+		}
+		else
+		{
+			return Stats;
+		}
+	}
+
+	TArray<FString> ExistingFiles;
+	FileManager.FindFilesRecursive(ExistingFiles, *StagingFolder, TEXT("*"), true, false, false);
+	for (const FString& Existing : ExistingFiles)
+	{
+		if (!StagedFiles.Contains(Existing) && FileManager.Delete(*Existing, false, true, true))
+		{
+			Stats.FilesRemoved++;
+		}
+	}
+
+	Stats.bSucceeded = true;
+	return Stats;
+}
+
+bool USteamUGCUploader::LinkStagedFile(const FString& Source, const FString& Dest)
+{
+#if PLATFORM_WINDOWS
+	return ::CreateHardLinkW(*Dest, *Source, nullptr) != 0;
+#elif PLATFORM_LINUX
+	return ::link(TCHAR_TO_UTF8(*Source), TCHAR_TO_UTF8(*Dest)) == 0;
+#else
+	return false;
+#endif
+}
+
+void USteamUGCUploader::OnSubmitItemUpdateResult(SubmitItemUpdateResult_t* pParam, bool bIOFailure)
+{
+	if (!m_bSubmitting)
+	{
+		return;
+	}
+
+	CompleteCurrentJob(bIOFailure ? ESteamResult::IOFailure : (ESteamResult)pParam->m_eResult, !bIOFailure && pParam->m_bUserNeedsToAcceptWorkshopLegalAgreement);
+
+	// Start the next update right away instead of waiting for the next poll
+	TrySubmitNext();
+	LaunchStaging();
+}
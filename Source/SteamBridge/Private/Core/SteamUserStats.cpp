@@ -2,9 +2,40 @@
 
 #include "Core/SteamUserStats.h"
 
+#include "Containers/Ticker.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "SteamBridgeSettings.h"
 #include "SteamBridgeUtils.h"
 
-USteamUserStats::USteamUserStats()
+namespace
+{
+	// How often the shadow store checks whether a store is due, slot writes never talk to Steam directly
+	constexpr float StatSlotsTickInterval = 0.25f;
+
+	// StoreStats normally answers within a few seconds, don't wait forever if UserStatsStored_t never arrives
+	constexpr double StoreStatsTimeout = 30.0;
+
+	// Steam allows 10 score uploads per 10 minutes
+	constexpr int32 MaxScoreUploadsPerWindow = 10;
+	constexpr double ScoreUploadWindow = 600.0;
+	constexpr float ScoreUploadTickInterval = 1.0f;
+	constexpr double ScoreUploadTimeout = 30.0;
+
+	constexpr uint32 QueuedScoresMagic = 0x53424C55;  // SBLU
+	constexpr int32 QueuedScoresVersion = 1;
+
+	FString GetQueuedScoresPath()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("SteamBridge/LeaderboardUploads.bin");
+	}
+}  // namespace
+
+USteamUserStats::USteamUserStats() :
+	m_NumDirtySlots(0), m_bStorePending(false), m_bStoreRequested(false), m_bStoreInFlight(false), m_bStatsReceived(false), m_NextStoreTime(0.0), m_BackoffUntil(0.0), m_StoreIssuedTime(0.0), m_StoreBackoff(0.0f), m_NextScoreUploadTime(0.0), m_ScoreUploadStartTime(0.0), m_ResolveStartTime(0.0), m_ScoreUploadBackoff(0.0f), m_bQueuedScoresLoaded(false)
 {
 	OnGlobalAchievementPercentagesReadyCallback.Register(this, &USteamUserStats::OnGlobalAchievementPercentagesReady);
 	OnGlobalStatsReceivedCallback.Register(this, &USteamUserStats::OnGlobalStatsReceived);
@@ -34,6 +65,16 @@ USteamUserStats::~USteamUserStats()
 	OnUserStatsReceivedCallback.Unregister();
 	OnUserStatsStoredCallback.Unregister();
 	OnUserStatsUnloadedCallback.Unregister();
+
+	if (m_StatSlotsTickHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(m_StatSlotsTickHandle);
+	}
+
+	if (m_ScoreUploadTickHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(m_ScoreUploadTickHandle);
+	}
 }
 
 FSteamAPICall USteamUserStats::DownloadLeaderboardEntries(FSteamLeaderboard SteamLeaderboard, ESteamLeaderboardDataRequest LeaderboardDataRequest, int32 RangeStart, int32 RangeEnd) const
@@ -48,37 +89,58 @@ FSteamAPICall USteamUserStats::FindOrCreateLeaderboard(const FString& Leaderboar
 
 bool USteamUserStats::GetDownloadedLeaderboardEntry(FSteamLeaderboardEntries SteamLeaderboardEntries, int32 index, FSteamLeaderboardEntry& LeaderboardEntry, TArray<int32>& Details, int32 DetailsMax) const
 {
-	Details.SetNum(DetailsMax);
+	DetailsMax = FMath::Clamp(DetailsMax, 0, k_cLeaderboardDetailsMax);
+	Details.SetNumUninitialized(DetailsMax, false);
 	LeaderboardEntry_t TmpEntry;
-	bool bResult = SteamUserStats()->GetDownloadedLeaderboardEntry(SteamLeaderboardEntries, index, &TmpEntry, Details.GetData(), DetailsMax);
+	bool bResult = SteamUserStats()->GetDownloadedLeaderboardEntry(SteamLeaderboardEntries, index, &TmpEntry, DetailsMax > 0 ? Details.GetData() : nullptr, DetailsMax);
 	LeaderboardEntry = TmpEntry;
+	Details.SetNum(bResult ? FMath::Min(TmpEntry.m_cDetails, DetailsMax) : 0, false);
 	return bResult;
 }
 
+bool USteamUserStats::GetGlobalStatFloat(const FString& StatName, float& Data) const
+{
+	double TmpData = 0.0;
+	const bool bResult = SteamUserStats()->GetGlobalStat(TCHAR_TO_UTF8(*StatName), &TmpData);
+	Data = (float)TmpData;
+	return bResult;
+}
+
+int32 USteamUserStats::GetGlobalStatHistoryInt64(const FString& StatName, TArray<int64>& Data, int32 Size) const
+{
+	Data.SetNumUninitialized(FMath::Max(0, Size));
+	const int32 result = Data.Num() > 0 ? SteamUserStats()->GetGlobalStatHistory(TCHAR_TO_UTF8(*StatName), Data.GetData(), Data.Num() * sizeof(int64)) : 0;
+	Data.SetNum(result, false);
+	return result;
+}
+
 int32 USteamUserStats::GetGlobalStatHistoryFloat(const FString& StatName, TArray<float>& Data, int32 Size) const
 {
-	TArray<double> TmpData;
-	int32 result = SteamUserStats()->GetGlobalStatHistory(TCHAR_TO_UTF8(*StatName), TmpData.GetData(), Size);
-	for (int32 i = 0; i < TmpData.Num(); i++)
+	TArray<double, TInlineAllocator<60>> TmpData;
+	TmpData.SetNumUninitialized(FMath::Max(0, Size));
+	const int32 result = TmpData.Num() > 0 ? SteamUserStats()->GetGlobalStatHistory(TCHAR_TO_UTF8(*StatName), TmpData.GetData(), TmpData.Num() * sizeof(double)) : 0;
+
+	Data.SetNumUninitialized(result);
+	for (int32 i = 0; i < result; i++)
 	{
-		Data.Add((float)TmpData[i]);
+		Data[i] = (float)TmpData[i];
 	}
 	return result;
 }
 
 int32 USteamUserStats::GetMostAchievedAchievementInfo(FString& Name, float& Percent, bool& bAchieved) const
 {
-	TArray<char> TmpName;
-	int32 result = SteamUserStats()->GetMostAchievedAchievementInfo(TmpName.GetData(), 1024, &Percent, &bAchieved);
-	Name = UTF8_TO_TCHAR(TmpName.GetData());
+	char TmpName[k_cchStatNameMax];
+	int32 result = SteamUserStats()->GetMostAchievedAchievementInfo(TmpName, k_cchStatNameMax, &Percent, &bAchieved);
+	Name = result != -1 ? UTF8_TO_TCHAR(TmpName) : FString();
 	return  result;
 }
 
 int32 USteamUserStats::GetNextMostAchievedAchievementInfo(int32 IteratorPrevious, FString& Name, float& Percent, bool& bAchieved) const
 {
-	TArray<char> TmpName;
-	int32 result = SteamUserStats()->GetNextMostAchievedAchievementInfo(IteratorPrevious, TmpName.GetData(), 1024, &Percent, &bAchieved);
-	Name = UTF8_TO_TCHAR(TmpName.GetData());
+	char TmpName[k_cchStatNameMax];
+	int32 result = SteamUserStats()->GetNextMostAchievedAchievementInfo(IteratorPrevious, TmpName, k_cchStatNameMax, &Percent, &bAchieved);
+	Name = result != -1 ? UTF8_TO_TCHAR(TmpName) : FString();
 	return  result;
 }
 
@@ -89,6 +151,11 @@ FSteamAPICall USteamUserStats::UploadLeaderboardScore(FSteamLeaderboard SteamLea
 
 void USteamUserStats::OnGlobalAchievementPercentagesReady(GlobalAchievementPercentagesReady_t* pParam)
 {
+	if (pParam->m_nGameID == SteamUtils()->GetAppID() && pParam->m_eResult == k_EResultOK)
+	{
+		BuildAchievementPercentages();
+	}
+
 	m_OnGlobalAchievementPercentagesReady.Broadcast(pParam->m_nGameID, (ESteamResult)pParam->m_eResult);
 }
 
@@ -99,6 +166,8 @@ void USteamUserStats::OnGlobalStatsReceived(GlobalStatsReceived_t* pParam)
 
 void USteamUserStats::OnLeaderboardFindResult(LeaderboardFindResult_t* pParam)
 {
+	// Leaderboards don't need the stats to be received, the first lookup is where a game without stats starts using them
+	LoadQueuedScores();
 	m_OnLeaderboardFindResult.Broadcast(pParam->m_hSteamLeaderboard, pParam->m_bLeaderboardFound == 1);
 }
 
@@ -134,11 +203,65 @@ void USteamUserStats::OnUserAchievementStored(UserAchievementStored_t* pParam)
 
 void USteamUserStats::OnUserStatsReceived(UserStatsReceived_t* pParam)
 {
+	if (pParam->m_nGameID == SteamUtils()->GetAppID() && pParam->m_steamIDUser == SteamUser()->GetSteamID() && pParam->m_eResult == k_EResultOK)
+	{
+		m_bStatsReceived = true;
+		BuildAchievementHandles();
+
+		LoadQueuedScores();
+
+		// Dirty slots keep their local value, it'll overwrite the received one on the next store
+		for (int32 i = 0; i < m_StatSlots.Num(); i++)
+		{
+			if (!m_DirtySlots[i])
+			{
+				ReadSlotFromSteam(m_StatSlots[i]);
+			}
+		}
+	}
+
 	m_OnUserStatsReceived.Broadcast(pParam->m_nGameID, (ESteamResult)pParam->m_eResult, pParam->m_steamIDUser.ConvertToUint64());
 }
 
 void USteamUserStats::OnUserStatsStored(UserStatsStored_t* pParam)
 {
+	if (pParam->m_nGameID == SteamUtils()->GetAppID() && m_bStoreInFlight)
+	{
+		m_bStoreInFlight = false;
+
+		const USteamBridgeSettings* const Settings = GetDefault<USteamBridgeSettings>();
+		switch (pParam->m_eResult)
+		{
+			case k_EResultOK: m_StoreBackoff = 0.0f; break;
+			case k_EResultRateLimitExceeded:
+			case k_EResultLimitExceeded:
+			case k_EResultBusy:
+			case k_EResultFail:
+				// The values are still in Steam's memory, only StoreStats has to be retried
+				m_bStorePending = true;
+				m_bStoreRequested = true;
+				m_StoreBackoff = FMath::Clamp(m_StoreBackoff * 2.0f, Settings->StatsMinBackoff, FMath::Max(Settings->StatsMinBackoff, Settings->StatsMaxBackoff));
+				m_BackoffUntil = FPlatformTime::Seconds() + m_StoreBackoff;
+				break;
+			case k_EResultInvalidParam:
+				// Steam rejected some of the values and reverted them, resync the slots that weren't changed since
+				for (int32 i = 0; i < m_StatSlots.Num(); i++)
+				{
+					if (!m_DirtySlots[i])
+					{
+						ReadSlotFromSteam(m_StatSlots[i]);
+					}
+				}
+				break;
+			default: break;
+		}
+
+		if (HasUnstoredStatSlots() && !m_StatSlotsTickHandle.IsValid())
+		{
+			m_StatSlotsTickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USteamUserStats::TickStatSlots), StatSlotsTickInterval);
+		}
+	}
+
 	m_OnUserStatsStored.Broadcast(pParam->m_nGameID, (ESteamResult)pParam->m_eResult);
 }
 
@@ -146,3 +269,489 @@ void USteamUserStats::OnUserStatsUnloaded(UserStatsUnloaded_t* pParam)
 {
 	m_OnUserStatsUnloaded.Broadcast(pParam->m_steamIDUser.ConvertToUint64());
 }
+
+FSteamStatHandle USteamUserStats::MakeStatHandle(const FString& Name)
+{
+	if (const FSteamStatHandle* const Existing = m_StatHandles.Find(Name))
+	{
+		return *Existing;
+	}
+	return m_StatHandles.Add(Name, FSteamStatHandle(Name));
+}
+
+bool USteamUserStats::GetGlobalStatFloat(const FSteamStatHandle& Handle, float& Data) const
+{
+	double TmpData = 0.0;
+	const bool bResult = SteamUserStats()->GetGlobalStat(Handle.Get(), &TmpData);
+	Data = (float)TmpData;
+	return bResult;
+}
+
+void USteamUserStats::BuildAchievementHandles()
+{
+	// The schema doesn't change during a session, only build the table again if it wasn't loaded before
+	const uint32 NumAchievements = SteamUserStats()->GetNumAchievements();
+	if ((uint32)m_AchievementHandles.Num() == NumAchievements)
+	{
+		return;
+	}
+
+	m_AchievementHandles.Reset(NumAchievements);
+	for (uint32 i = 0; i < NumAchievements; i++)
+	{
+		const FString Name = UTF8_TO_TCHAR(SteamUserStats()->GetAchievementName(i));
+		m_AchievementHandles.Add(MakeStatHandle(Name));
+	}
+}
+
+void USteamUserStats::BuildAchievementPercentages()
+{
+	ISteamUserStats* const UserStats = SteamUserStats();
+	m_AchievementPercentages.Reset(UserStats->GetNumAchievements());
+
+	// The iterator already walks the achievements from the most to the least achieved
+	char Name[k_cchStatNameMax];
+	float Percent = 0.0f;
+	bool bAchieved = false;
+	for (int32 Iterator = UserStats->GetMostAchievedAchievementInfo(Name, k_cchStatNameMax, &Percent, &bAchieved); Iterator != -1;
+		 Iterator = UserStats->GetNextMostAchievedAchievementInfo(Iterator, Name, k_cchStatNameMax, &Percent, &bAchieved))
+	{
+		m_AchievementPercentages.Emplace(MakeStatHandle(UTF8_TO_TCHAR(Name)), Percent, bAchieved);
+	}
+}
+
+int32 USteamUserStats::ResolveStatSlot(const FString& Name, ESteamStatSlotType Type)
+{
+	if (const int32* const Existing = m_StatSlotIndices.Find(Name))
+	{
+		return m_StatSlots[*Existing].Type == Type ? *Existing : INDEX_NONE;
+	}
+
+	FStatSlot& StatSlot = m_StatSlots.AddDefaulted_GetRef();
+	StatSlot.Handle = MakeStatHandle(Name);
+	StatSlot.Type = Type;
+	StatSlot.IntValue = 0;
+	StatSlot.FloatValue = 0.0f;
+
+	if (m_bStatsReceived)
+	{
+		ReadSlotFromSteam(StatSlot);
+	}
+
+	m_DirtySlots.Add(false);
+	return m_StatSlotIndices.Add(Name, m_StatSlots.Num() - 1);
+}
+
+void USteamUserStats::SetStatSlotInt32(int32 Slot, int32 Value)
+{
+	if (m_StatSlots.IsValidIndex(Slot) && m_StatSlots[Slot].Type == ESteamStatSlotType::Int32 && m_StatSlots[Slot].IntValue != Value)
+	{
+		m_StatSlots[Slot].IntValue = Value;
+		MarkSlotDirty(Slot, false);
+	}
+}
+
+void USteamUserStats::AddStatSlotInt32(int32 Slot, int32 Delta)
+{
+	if (m_StatSlots.IsValidIndex(Slot))
+	{
+		SetStatSlotInt32(Slot, m_StatSlots[Slot].IntValue + Delta);
+	}
+}
+
+void USteamUserStats::SetStatSlotFloat(int32 Slot, float Value)
+{
+	if (m_StatSlots.IsValidIndex(Slot) && m_StatSlots[Slot].Type == ESteamStatSlotType::Float && m_StatSlots[Slot].FloatValue != Value)
+	{
+		m_StatSlots[Slot].FloatValue = Value;
+		MarkSlotDirty(Slot, false);
+	}
+}
+
+void USteamUserStats::UnlockAchievementSlot(int32 Slot)
+{
+	if (m_StatSlots.IsValidIndex(Slot) && m_StatSlots[Slot].Type == ESteamStatSlotType::Achievement && m_StatSlots[Slot].IntValue == 0)
+	{
+		m_StatSlots[Slot].IntValue = 1;
+		MarkSlotDirty(Slot, true);
+	}
+}
+
+void USteamUserStats::FlushStatSlots()
+{
+	if (m_NumDirtySlots > 0 || m_bStorePending)
+	{
+		m_bStoreRequested = true;
+		if (!m_StatSlotsTickHandle.IsValid())
+		{
+			m_StatSlotsTickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USteamUserStats::TickStatSlots), StatSlotsTickInterval);
+		}
+	}
+}
+
+void USteamUserStats::MarkSlotDirty(int32 Slot, bool bImportant)
+{
+	if (!m_DirtySlots[Slot])
+	{
+		m_DirtySlots[Slot] = true;
+		m_NumDirtySlots++;
+	}
+
+	// The flush interval starts with the first change, not with the first tick
+	if (m_NextStoreTime == 0.0)
+	{
+		m_NextStoreTime = FPlatformTime::Seconds() + GetDefault<USteamBridgeSettings>()->StatsFlushInterval;
+	}
+
+	m_bStoreRequested |= bImportant;
+	if (!m_StatSlotsTickHandle.IsValid())
+	{
+		m_StatSlotsTickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USteamUserStats::TickStatSlots), StatSlotsTickInterval);
+	}
+}
+
+void USteamUserStats::ReadSlotFromSteam(FStatSlot& StatSlot) const
+{
+	switch (StatSlot.Type)
+	{
+		case ESteamStatSlotType::Int32: SteamUserStats()->GetStat(StatSlot.Handle.Get(), &StatSlot.IntValue); break;
+		case ESteamStatSlotType::Float: SteamUserStats()->GetStat(StatSlot.Handle.Get(), &StatSlot.FloatValue); break;
+		case ESteamStatSlotType::Achievement:
+		{
+			bool bAchieved = false;
+			SteamUserStats()->GetAchievement(StatSlot.Handle.Get(), &bAchieved);
+			StatSlot.IntValue = bAchieved ? 1 : 0;
+			break;
+		}
+		default: break;
+	}
+}
+
+bool USteamUserStats::TickStatSlots(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+
+	if (m_bStoreInFlight)
+	{
+		if (Now - m_StoreIssuedTime < StoreStatsTimeout)
+		{
+			return true;
+		}
+		m_bStoreInFlight = false;
+		m_bStorePending = true;
+	}
+
+	if (m_NumDirtySlots == 0 && !m_bStorePending)
+	{
+		m_bStoreRequested = false;
+		m_NextStoreTime = 0.0;
+		m_StatSlotsTickHandle.Reset();
+		return false;
+	}
+
+	// SetStat fails until the current stats were received, keep everything dirty until then
+	const bool bStoreDue = Now >= m_BackoffUntil && (m_bStoreRequested || Now >= m_NextStoreTime);
+	if (!m_bStatsReceived || !bStoreDue)
+	{
+		return true;
+	}
+
+	for (TConstSetBitIterator<> It(m_DirtySlots); It; ++It)
+	{
+		const FStatSlot& StatSlot = m_StatSlots[It.GetIndex()];
+		switch (StatSlot.Type)
+		{
+			case ESteamStatSlotType::Int32: SteamUserStats()->SetStat(StatSlot.Handle.Get(), StatSlot.IntValue); break;
+			case ESteamStatSlotType::Float: SteamUserStats()->SetStat(StatSlot.Handle.Get(), StatSlot.FloatValue); break;
+			case ESteamStatSlotType::Achievement:
+				if (StatSlot.IntValue != 0)
+				{
+					SteamUserStats()->SetAchievement(StatSlot.Handle.Get());
+				}
+				break;
+			default: break;
+		}
+	}
+
+	m_DirtySlots.Init(false, m_DirtySlots.Num());
+	m_NumDirtySlots = 0;
+
+	m_bStoreInFlight = SteamUserStats()->StoreStats();
+	m_bStorePending = !m_bStoreInFlight;
+	m_bStoreRequested = m_bStorePending;
+	m_StoreIssuedTime = Now;
+	if (m_bStorePending)
+	{
+		m_BackoffUntil = Now + GetDefault<USteamBridgeSettings>()->StatsMinBackoff;
+	}
+	m_NextStoreTime = Now + GetDefault<USteamBridgeSettings>()->StatsFlushInterval;
+	return true;
+}
+
+void USteamUserStats::QueueLeaderboardScore(FSteamLeaderboard SteamLeaderboard, ESteamLeaderboardUploadScoreMethod LeaderboardUploadScoreMethod, int32 Score, const TArray<int32>& ScoreDetails)
+{
+	LoadQueuedScores();
+
+	const ELeaderboardUploadScoreMethod Method = (ELeaderboardUploadScoreMethod)LeaderboardUploadScoreMethod;
+	const int32 NumDetails = FMath::Min(ScoreDetails.Num(), k_cLeaderboardDetailsMax);
+	const FString LeaderboardName = UTF8_TO_TCHAR(SteamUserStats()->GetLeaderboardName(SteamLeaderboard));
+
+	// Scores loaded from disk for this leaderboard don't have to wait for a lookup, and they have to be coalesced with like any other
+	for (FQueuedScore& Queued : m_QueuedScores)
+	{
+		if (Queued.Leaderboard == 0 && Queued.LeaderboardName == LeaderboardName)
+		{
+			Queued.Leaderboard = SteamLeaderboard;
+		}
+	}
+
+	if (Method == k_ELeaderboardUploadScoreMethodForceUpdate)
+	{
+		// A forced score replaces whatever the scores queued before it would have left on the leaderboard
+		m_QueuedScores.RemoveAll([SteamLeaderboard](const FQueuedScore& Queued) { return !Queued.bInFlight && Queued.Leaderboard == SteamLeaderboard; });
+	}
+	else
+	{
+		const int32 LastIndex = m_QueuedScores.FindLastByPredicate([SteamLeaderboard](const FQueuedScore& Queued) { return !Queued.bInFlight && Queued.Leaderboard == SteamLeaderboard; });
+		if (LastIndex != INDEX_NONE && m_QueuedScores[LastIndex].Method == k_ELeaderboardUploadScoreMethodKeepBest)
+		{
+			FQueuedScore& Queued = m_QueuedScores[LastIndex];
+			const bool bAscending = SteamUserStats()->GetLeaderboardSortMethod(SteamLeaderboard) == k_ELeaderboardSortMethodAscending;
+			if (bAscending ? Score < Queued.Score : Score > Queued.Score)
+			{
+				Queued.Score = Score;
+				Queued.Details.Reset(NumDetails);
+				Queued.Details.Append(ScoreDetails.GetData(), NumDetails);
+				SaveQueuedScores();
+			}
+			return;
+		}
+	}
+
+	FQueuedScore& Queued = m_QueuedScores.AddDefaulted_GetRef();
+	Queued.LeaderboardName = LeaderboardName;
+	Queued.Leaderboard = SteamLeaderboard;
+	Queued.Method = Method;
+	Queued.Score = Score;
+	Queued.Details.Append(ScoreDetails.GetData(), NumDetails);
+	Queued.bInFlight = false;
+
+	SaveQueuedScores();
+	StartScoreUploads();
+}
+
+void USteamUserStats::LoadQueuedScores()
+{
+	if (m_bQueuedScoresLoaded)
+	{
+		return;
+	}
+
+	m_bQueuedScoresLoaded = true;
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *GetQueuedScoresPath(), FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Ar(Data);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	int32 Count = 0;
+	Ar << Magic << Version << Count;
+	if (Magic != QueuedScoresMagic || Version != QueuedScoresVersion || Count < 0)
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < Count && !Ar.IsError(); i++)
+	{
+		FQueuedScore Queued;
+		uint8 Method = 0;
+		Ar << Queued.LeaderboardName << Method << Queued.Score << Queued.Details;
+
+		// Leaderboard stays 0 until the name is found again
+		Queued.Leaderboard = 0;
+		Queued.Method = (ELeaderboardUploadScoreMethod)Method;
+		Queued.bInFlight = false;
+		if (!Ar.IsError() && !Queued.LeaderboardName.IsEmpty())
+		{
+			m_QueuedScores.Add(MoveTemp(Queued));
+		}
+	}
+
+	StartScoreUploads();
+}
+
+void USteamUserStats::SaveQueuedScores()
+{
+	const FString Path = GetQueuedScoresPath();
+	if (m_QueuedScores.Num() == 0)
+	{
+		IFileManager::Get().Delete(*Path, false, false, true);
+		return;
+	}
+
+	TArray<uint8> Data;
+	FMemoryWriter Ar(Data);
+
+	uint32 Magic = QueuedScoresMagic;
+	int32 Version = QueuedScoresVersion;
+	int32 Count = m_QueuedScores.Num();
+	Ar << Magic << Version << Count;
+
+	for (FQueuedScore& Queued : m_QueuedScores)
+	{
+		uint8 Method = (uint8)Queued.Method;
+		Ar << Queued.LeaderboardName << Method << Queued.Score << Queued.Details;
+	}
+
+	// Written next to the queue and moved over it so a crash while saving never leaves a truncated file behind
+	const FString TempPath = Path + TEXT(".tmp");
+	if (FFileHelper::SaveArrayToFile(Data, *TempPath))
+	{
+		IFileManager::Get().Move(*Path, *TempPath, true, true);
+	}
+}
+
+void USteamUserStats::StartScoreUploads()
+{
+	if (m_QueuedScores.Num() > 0 && !m_ScoreUploadTickHandle.IsValid())
+	{
+		m_ScoreUploadTickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USteamUserStats::TickScoreUploads), ScoreUploadTickInterval);
+	}
+}
+
+bool USteamUserStats::TickScoreUploads(float DeltaTime)
+{
+	if (m_QueuedScores.Num() == 0)
+	{
+		m_ScoreUploadTickHandle.Reset();
+		return false;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+
+	// Only one upload may be outstanding at a time
+	const int32 InFlightIndex = m_QueuedScores.IndexOfByPredicate([](const FQueuedScore& Queued) { return Queued.bInFlight; });
+	if (InFlightIndex != INDEX_NONE)
+	{
+		if (Now - m_ScoreUploadStartTime < ScoreUploadTimeout)
+		{
+			return true;
+		}
+		m_ScoreQueueUploadCall.Cancel();
+		m_QueuedScores[InFlightIndex].bInFlight = false;
+	}
+
+	// Scores loaded from disk need their leaderboard found again, one name at a time
+	if (!m_ResolvingLeaderboardName.IsEmpty() && Now - m_ResolveStartTime >= ScoreUploadTimeout)
+	{
+		m_ScoreQueueFindCall.Cancel();
+		m_ResolvingLeaderboardName.Reset();
+	}
+
+	if (m_ResolvingLeaderboardName.IsEmpty())
+	{
+		const FQueuedScore* const Unresolved = m_QueuedScores.FindByPredicate([](const FQueuedScore& Queued) { return Queued.Leaderboard == 0; });
+		if (Unresolved != nullptr)
+		{
+			const SteamAPICall_t Call = SteamUserStats()->FindLeaderboard(TCHAR_TO_UTF8(*Unresolved->LeaderboardName));
+			if (Call != k_uAPICallInvalid)
+			{
+				m_ScoreQueueFindCall.Set(Call, this, &USteamUserStats::OnQueuedLeaderboardFound);
+				m_ResolvingLeaderboardName = Unresolved->LeaderboardName;
+				m_ResolveStartTime = Now;
+			}
+		}
+	}
+
+	if (Now < m_NextScoreUploadTime)
+	{
+		return true;
+	}
+
+	m_ScoreUploadTimes.RemoveAll([Now](double Time) { return Now - Time >= ScoreUploadWindow; });
+	if (m_ScoreUploadTimes.Num() >= MaxScoreUploadsPerWindow)
+	{
+		m_NextScoreUploadTime = m_ScoreUploadTimes[0] + ScoreUploadWindow;
+		return true;
+	}
+
+	FQueuedScore* const Next = m_QueuedScores.FindByPredicate([](const FQueuedScore& Queued) { return Queued.Leaderboard != 0; });
+	if (Next == nullptr)
+	{
+		return true;
+	}
+
+	const SteamAPICall_t Call = SteamUserStats()->UploadLeaderboardScore(Next->Leaderboard, Next->Method, Next->Score, Next->Details.GetData(), Next->Details.Num());
+	if (Call != k_uAPICallInvalid)
+	{
+		m_ScoreQueueUploadCall.Set(Call, this, &USteamUserStats::OnQueuedScoreUploaded);
+		Next->bInFlight = true;
+		m_ScoreUploadStartTime = Now;
+		m_ScoreUploadTimes.Add(Now);
+	}
+	else
+	{
+		m_NextScoreUploadTime = Now + GetDefault<USteamBridgeSettings>()->StatsMinBackoff;
+	}
+
+	return true;
+}
+
+void USteamUserStats::OnQueuedLeaderboardFound(LeaderboardFindResult_t* pParam, bool bIOFailure)
+{
+	const FString LeaderboardName = MoveTemp(m_ResolvingLeaderboardName);
+	m_ResolvingLeaderboardName.Reset();
+
+	// Only drop the queued scores when Steam answered that the leaderboard doesn't exist, a failed call is retried on a later tick
+	if (bIOFailure)
+	{
+		return;
+	}
+
+	for (int32 i = m_QueuedScores.Num() - 1; i >= 0; i--)
+	{
+		if (m_QueuedScores[i].Leaderboard == 0 && m_QueuedScores[i].LeaderboardName == LeaderboardName)
+		{
+			if (pParam->m_bLeaderboardFound)
+			{
+				m_QueuedScores[i].Leaderboard = pParam->m_hSteamLeaderboard;
+			}
+			else
+			{
+				m_QueuedScores.RemoveAt(i);
+			}
+		}
+	}
+
+	if (!pParam->m_bLeaderboardFound)
+	{
+		SaveQueuedScores();
+	}
+}
+
+void USteamUserStats::OnQueuedScoreUploaded(LeaderboardScoreUploaded_t* pParam, bool bIOFailure)
+{
+	const int32 InFlightIndex = m_QueuedScores.IndexOfByPredicate([](const FQueuedScore& Queued) { return Queued.bInFlight; });
+	if (InFlightIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (!bIOFailure && pParam->m_bSuccess)
+	{
+		m_QueuedScores.RemoveAt(InFlightIndex);
+		m_ScoreUploadBackoff = 0.0f;
+		SaveQueuedScores();
+	}
+	else
+	{
+		const USteamBridgeSettings* const Settings = GetDefault<USteamBridgeSettings>();
+		m_QueuedScores[InFlightIndex].bInFlight = false;
+		m_ScoreUploadBackoff = FMath::Clamp(m_ScoreUploadBackoff * 2.0f, Settings->StatsMinBackoff, FMath::Max(Settings->StatsMinBackoff, Settings->StatsMaxBackoff));
+		m_NextScoreUploadTime = FPlatformTime::Seconds() + m_ScoreUploadBackoff;
+	}
+}
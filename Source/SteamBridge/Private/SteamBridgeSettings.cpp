@@ -3,3 +3,7 @@
 
 #include "SteamBridgeSettings.h"
 
+USteamBridgeSettings::USteamBridgeSettings() :
+	bTest(false), StatsFlushInterval(60.0f), StatsMinBackoff(10.0f), StatsMaxBackoff(600.0f), CloudReserveBytes(1024 * 1024), HTTPCacheMaxBytes(64 * 1024 * 1024)
+{
+}
@@ -19,6 +19,22 @@ FString USteamBridgeUtils::ConvertIPToString(uint32 IP)
 	return FString::FromInt(IP >> 24) + "." + FString::FromInt((IP >> 16) % 256) + "." + FString::FromInt((IP >> 8) % 256) + "." + FString::FromInt(IP % 256);
 }
 
+void USteamBridgeUtils::ConvertUTF8ToString(const char* Buffer, int32 BufferSize, FString& Dest)
+{
+	TArray<TCHAR>& CharArray = Dest.GetCharArray();
+	const int32 SourceLength = Buffer != nullptr ? FCStringAnsi::Strnlen(Buffer, BufferSize) : 0;
+	if (SourceLength == 0)
+	{
+		CharArray.Reset();
+		return;
+	}
+
+	const int32 DestLength = FUTF8ToTCHAR_Convert::ConvertedLength(Buffer, SourceLength);
+	CharArray.SetNumUninitialized(DestLength + 1, false);
+	FUTF8ToTCHAR_Convert::Convert(CharArray.GetData(), DestLength, Buffer, SourceLength);
+	CharArray[DestLength] = TEXT('\0');
+}
+
 FString USteamBridgeUtils::GetSteamIDAsString(const FSteamID& SteamID)
 {
 	return FString::Printf(TEXT("%llu"), SteamID.Value);
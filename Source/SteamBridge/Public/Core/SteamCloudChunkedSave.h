@@ -0,0 +1,111 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "Async/Future.h"
+#include "CoreMinimal.h"
+#include "Core/SteamRemoteStorage.h"
+#include "Misc/SecureHash.h"
+#include "Steam.h"
+#include "SteamEnums.h"
+#include "SteamStructs.h"
+#include "UObject/NoExportTypes.h"
+
+#include "SteamCloudChunkedSave.generated.h"
+
+/**
+ * Stores saves in the Steam Cloud as content-defined chunks so a small edit to a large save only uploads the chunks around it.
+ * A save named "Slot" is written as "Slot.manifest", which lists the SHA-1 and size of every chunk in order, and one "Slot.chunks/<SHA-1>" file per distinct chunk.
+ * Chunk boundaries come from a rolling hash of the data rather than fixed offsets, so inserting or removing bytes only changes the chunks it touches.
+ * The manifest is written after all of its chunks, so an interrupted save leaves the previous one readable.
+ */
+UCLASS()
+class STEAMBRIDGE_API USteamCloudChunkedSave final : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore", meta = (DisplayName = "Steam Cloud Chunked Save", CompactNodeTitle = "SteamCloudChunkedSave"))
+	static USteamCloudChunkedSave* GetSteamCloudChunkedSave() { return USteamCloudChunkedSave::StaticClass()->GetDefaultObject<USteamCloudChunkedSave>(); }
+
+	/**
+	 * Writes the chunks of a save that aren't in the cloud yet, then its manifest, then deletes the chunks the previous version used and this one doesn't.
+	 *
+	 * @param const FString & SaveName - The name of the save, used as the prefix of its files.
+	 * @param TArray<uint8> && Data - The serialized save.
+	 * @return TFuture<ESteamResult> - Set on the game thread once the save finished. Busy if the same save is already being written.
+	 */
+	TFuture<ESteamResult> SaveAsync(const FString& SaveName, TArray<uint8>&& Data);
+
+	/**
+	 * Reads the manifest of a save, then all of its chunks at once, and reassembles them.
+	 *
+	 * @param const FString & SaveName - The name of the save.
+	 * @return TFuture<FSteamCloudReadResult> - Set on the game thread once every chunk was read and verified.
+	 */
+	TFuture<FSteamCloudReadResult> LoadAsync(const FString& SaveName);
+
+	/**
+	 * Deletes the manifest and every chunk of a save.
+	 *
+	 * @param const FString & SaveName - The name of the save.
+	 * @return bool - false if the save doesn't exist or is being written.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
+	bool DeleteSave(const FString& SaveName);
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|RemoteStorage")
+	bool SaveExists(const FString& SaveName) const { return SteamRemoteStorage()->FileExists(TCHAR_TO_UTF8(*GetManifestName(SaveName))); }
+
+	/** The number of bytes the last SaveAsync of a save actually wrote, chunks and manifest included. */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|RemoteStorage")
+	int64 GetLastBytesWritten(const FString& SaveName) const { return m_LastBytesWritten.FindRef(SaveName); }
+
+protected:
+private:
+	struct FChunk
+	{
+		FSHAHash Hash;
+		int32 Size;
+
+		friend FArchive& operator<<(FArchive& Ar, FChunk& Chunk) { return Ar << Chunk.Hash << Chunk.Size; }
+	};
+
+	struct FSaveOperation
+	{
+		FString SaveName;
+		TPromise<ESteamResult> Promise;
+		TArray<FChunk> Chunks;
+		TArray<FString> ChunkNames;  // Parallel to Chunks
+		int32 NumPendingWrites;
+		int64 BytesWritten;
+		ESteamResult Result;
+	};
+
+	struct FLoadOperation
+	{
+		FString SaveName;
+		TPromise<FSteamCloudReadResult> Promise;
+		TArray<uint8> Data;
+		int32 NumPendingReads;
+		ESteamResult Result;
+	};
+
+	static FString GetManifestName(const FString& SaveName) { return SaveName + TEXT(".manifest"); }
+	static FString GetChunkPrefix(const FString& SaveName) { return SaveName + TEXT(".chunks/"); }
+	static FString GetChunkName(const FString& SaveName, const FSHAHash& Hash) { return GetChunkPrefix(SaveName) + Hash.ToString(); }
+
+	static void SplitIntoChunks(const TArray<uint8>& Data, TArray<FChunk>& Chunks);
+	static bool SerializeManifest(FArchive& Ar, TArray<FChunk>& Chunks, int64& TotalSize);
+
+	void HandleChunkWritten(const TSharedRef<FSaveOperation>& Operation, ESteamResult Result);
+	void WriteManifest(const TSharedRef<FSaveOperation>& Operation);
+	void FinishSave(const TSharedRef<FSaveOperation>& Operation, ESteamResult Result);
+	void DeleteUnusedChunks(const FString& SaveName, const TArray<FChunk>& Chunks);
+
+	void HandleManifestRead(const TSharedRef<FLoadOperation>& Operation, const FSteamCloudReadResult& ReadResult);
+	void FinishLoad(const TSharedRef<FLoadOperation>& Operation);
+
+	TSet<FString> m_SavesInFlight;
+	TMap<FString, int64> m_LastBytesWritten;
+};
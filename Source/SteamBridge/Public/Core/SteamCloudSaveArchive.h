@@ -0,0 +1,103 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "Async/Future.h"
+#include "CoreMinimal.h"
+#include "Serialization/Archive.h"
+#include "Steam.h"
+
+/**
+ * Serializes a save straight into a Steam Cloud file with FileWriteStreamOpen/WriteChunk/Close.
+ * The data is cut into chunks of a fixed size which are compressed on a worker thread while the next chunk is filled,
+ * so the memory used is a few chunks no matter how large the save is. The file only replaces the existing one once Close succeeds.
+ *
+ *	FSteamCloudSaveWriter Writer(TEXT("save0.sav"));
+ *	SaveGame->Serialize(Writer);
+ *	const bool bSaved = Writer.Close();
+ *
+ * Read the file back with FSteamCloudSaveReader.
+ */
+class STEAMBRIDGE_API FSteamCloudSaveWriter final : public FArchive
+{
+public:
+	static constexpr int32 DefaultChunkSize = 256 * 1024;
+
+	/**
+	 * Opens a write stream to a file in the Steam Cloud. The archive is in an error state if the stream couldn't be opened.
+	 *
+	 * @param const FString & FileName - The name of the file to write.
+	 * @param int32 ChunkSize - How many bytes are compressed at a time.
+	 */
+	explicit FSteamCloudSaveWriter(const FString& FileName, int32 ChunkSize = DefaultChunkSize);
+
+	/** Cancels the write stream if Close wasn't called, the existing file is left untouched. */
+	virtual ~FSteamCloudSaveWriter();
+
+	FSteamCloudSaveWriter(const FSteamCloudSaveWriter&) = delete;
+	FSteamCloudSaveWriter& operator=(const FSteamCloudSaveWriter&) = delete;
+
+	/**
+	 * Writes the last chunk and closes the stream, replacing the existing file.
+	 *
+	 * @return bool - false if anything failed to compress or write, the stream is cancelled instead.
+	 */
+	bool Close();
+
+	bool IsOpen() const { return m_WriteHandle != k_UGCFileStreamHandleInvalid; }
+
+	virtual void Serialize(void* Data, int64 Num) override;
+	virtual int64 Tell() override { return m_TotalSize; }
+	virtual int64 TotalSize() override { return m_TotalSize; }
+	virtual FString GetArchiveName() const override { return m_FileName; }
+
+protected:
+private:
+	void SubmitChunk();
+	void WriteCompressedChunk();
+	void Cancel();
+
+	FString m_FileName;
+	UGCFileWriteStreamHandle_t m_WriteHandle;
+	int32 m_ChunkSize;
+	int64 m_TotalSize;
+
+	// The chunk being filled, the one the worker is compressing and its output. They're swapped instead of reallocated.
+	TArray<uint8> m_FillingChunk;
+	TArray<uint8> m_CompressingChunk;
+	TArray<uint8> m_CompressedChunk;
+	TFuture<void> m_Compression;
+};
+
+/**
+ * Reads a file written by FSteamCloudSaveWriter, e.g. the data returned by USteamRemoteStorage::FileRead or ReadFileAsync.
+ * Chunks are decompressed one at a time as they're serialized so only one uncompressed chunk is held next to the file.
+ * The archive is in an error state if the data isn't a valid cloud save.
+ */
+class STEAMBRIDGE_API FSteamCloudSaveReader final : public FArchive
+{
+public:
+	explicit FSteamCloudSaveReader(TArray<uint8>&& FileData);
+
+	virtual void Serialize(void* Data, int64 Num) override;
+	virtual int64 Tell() override { return m_Position; }
+	virtual int64 TotalSize() override { return m_TotalSize; }
+	virtual FString GetArchiveName() const override { return TEXT("FSteamCloudSaveReader"); }
+
+	/** Gives the file data back, e.g. to return it with USteamRemoteStorage::ReleaseBuffer. */
+	TArray<uint8> ReleaseFileData() { return MoveTemp(m_FileData); }
+
+protected:
+private:
+	bool DecompressNextChunk();
+
+	TArray<uint8> m_FileData;
+	FName m_CompressionFormat;
+	int32 m_FileOffset;  // Offset of the next chunk header in m_FileData
+
+	TArray<uint8> m_Chunk;
+	int32 m_ChunkOffset;
+
+	int64 m_Position;
+	int64 m_TotalSize;
+};
@@ -0,0 +1,134 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Steam.h"
+#include "SteamEnums.h"
+#include "SteamStructs.h"
+#include "UObject/NoExportTypes.h"
+
+#include "SteamGlobalStats.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSteamGlobalStatsUpdatedDelegate, ESteamResult, Result);
+
+/**
+ * Requests global stats once and reads the totals and daily history of every registered stat into memory.
+ * Histories are stored per stat in columnar int64 and double buffers, starting with today, and stay cached until the next request.
+ * Deltas and moving averages are computed from the cached columns without calling into Steam.
+ */
+UCLASS()
+class STEAMBRIDGE_API USteamGlobalStats final : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	USteamGlobalStats();
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore", meta = (DisplayName = "Steam Global Stats", CompactNodeTitle = "SteamGlobalStats"))
+	static USteamGlobalStats* GetSteamGlobalStats() { return USteamGlobalStats::StaticClass()->GetDefaultObject<USteamGlobalStats>(); }
+
+	/**
+	 * Adds stats to read when the global stats are received. The type must match the one in the Steamworks Partner backend.
+	 *
+	 * @param const TArray<FString> & Int64StatNames - The 'API Names' of INT stats.
+	 * @param const TArray<FString> & DoubleStatNames - The 'API Names' of FLOAT and AVGRATE stats.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	void RegisterStats(const TArray<FString>& Int64StatNames, const TArray<FString>& DoubleStatNames);
+
+	/**
+	 * Calls RequestGlobalStats once and reads every registered stat when it's received. OnGlobalStatsUpdated is called afterwards.
+	 *
+	 * @param int32 HistoryDays - How many days of history to read, up to 60.
+	 * @return bool - false if a request is already pending or it couldn't be made.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	bool RequestGlobalStats(int32 HistoryDays = 7);
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UserStats")
+	bool IsRequestPending() const { return m_bRequestPending; }
+
+	/** The number of days of history that was requested. Stats can return fewer days. */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UserStats")
+	int32 GetHistoryDays() const { return m_HistoryDays; }
+
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|UserStats")
+	bool GetTotalInt64(const FString& StatName, int64& Total) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|UserStats")
+	bool GetTotalFloat(const FString& StatName, float& Total) const;
+
+	/**
+	 * Gets the daily values of a stat, History[0] is today.
+	 *
+	 * @param const FString & StatName - The 'API Name' of a registered stat.
+	 * @param TArray<float> & History - The daily values.
+	 * @return bool - false if the stat isn't registered or wasn't received.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|UserStats")
+	bool GetHistory(const FString& StatName, TArray<float>& History) const;
+
+	/**
+	 * Gets the change of a stat from one day to the next, Deltas[0] is today minus yesterday.
+	 *
+	 * @param const FString & StatName - The 'API Name' of a registered stat.
+	 * @param TArray<float> & Deltas - One less value than the history.
+	 * @return bool - false if the stat isn't registered or wasn't received.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|UserStats")
+	bool GetDailyDeltas(const FString& StatName, TArray<float>& Deltas) const;
+
+	/**
+	 * Gets the moving average of a stat over a number of days, Averages[0] is the average of today and the WindowDays - 1 days before it.
+	 *
+	 * @param const FString & StatName - The 'API Name' of a registered stat.
+	 * @param int32 WindowDays - The number of days averaged.
+	 * @param TArray<float> & Averages - WindowDays - 1 less values than the history.
+	 * @return bool - false if the stat isn't registered or wasn't received.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|UserStats")
+	bool GetMovingAverage(const FString& StatName, int32 WindowDays, TArray<float>& Averages) const;
+
+	/** The cached daily values of an INT stat without copying, empty if it isn't registered as one. */
+	TArrayView<const int64> GetInt64History(const FString& StatName) const;
+
+	/** The cached daily values of a FLOAT or AVGRATE stat without copying, empty if it isn't registered as one. */
+	TArrayView<const double> GetDoubleHistory(const FString& StatName) const;
+
+	/** Called once every registered stat was read after RequestGlobalStats. */
+	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|UserStats", meta = (DisplayName = "OnGlobalStatsUpdated"))
+	FOnSteamGlobalStatsUpdatedDelegate m_OnGlobalStatsUpdated;
+
+protected:
+private:
+	struct FGlobalStat
+	{
+		FSteamStatHandle Handle;
+		bool bDouble;
+		int32 Column;  // Column of the stat in the int64 or double buffers
+		int32 NumDays;  // Days of history Steam returned, at most m_HistoryDays
+	};
+
+	const FGlobalStat* FindStat(const FString& StatName) const;
+	double GetValue(const FGlobalStat& Stat, int32 Day) const;
+
+	UFUNCTION()
+	void HandleGlobalStatsReceived(int64 GameID, ESteamResult Result);
+
+	TArray<FGlobalStat> m_Stats;
+	TMap<FString, int32> m_StatIndices;
+	int32 m_NumInt64Stats;
+	int32 m_NumDoubleStats;
+
+	// Column major, the history of a stat is m_HistoryDays values starting at Column * m_HistoryDays
+	TArray<int64> m_Int64History;
+	TArray<double> m_DoubleHistory;
+	TArray<int64> m_Int64Totals;
+	TArray<double> m_DoubleTotals;
+
+	int32 m_HistoryDays;
+	int32 m_RequestedHistoryDays;
+	bool m_bRequestPending;
+};
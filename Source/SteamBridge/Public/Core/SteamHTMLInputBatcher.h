@@ -0,0 +1,111 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Steam.h"
+#include "SteamEnums.h"
+#include "SteamStructs.h"
+#include "UObject/NoExportTypes.h"
+
+#include "SteamHTMLInputBatcher.generated.h"
+
+/**
+ * Queues the input an in-game browser forwards to USteamHTMLSurface and sends it once per frame.
+ * Consecutive mouse moves are collapsed into the last position and consecutive wheel deltas are summed, everything else is sent
+ * in the order it was queued so clicks land where the cursor was and typed text stays intact.
+ * Use it in place of the input functions of USteamHTMLSurface, they take the same arguments.
+ */
+UCLASS()
+class STEAMBRIDGE_API USteamHTMLInputBatcher final : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	~USteamHTMLInputBatcher();
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore", meta = (DisplayName = "Steam HTML Input Batcher", CompactNodeTitle = "SteamHTMLInputBatcher"))
+	static USteamHTMLInputBatcher* GetSteamHTMLInputBatcher() { return USteamHTMLInputBatcher::StaticClass()->GetDefaultObject<USteamHTMLInputBatcher>(); }
+
+	/** Queues a mouse move, replacing a move queued right before it. */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|HTMLSurface")
+	void MouseMove(FHHTMLBrowser BrowserHandle, int32 x, int32 y) { QueueEvent(BrowserHandle, EInputType::MouseMove, x, y); }
+
+	/** Queues a mouse wheel delta, added to a wheel delta queued right before it. */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|HTMLSurface")
+	void MouseWheel(FHHTMLBrowser BrowserHandle, int32 Delta) { QueueEvent(BrowserHandle, EInputType::MouseWheel, Delta); }
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|HTMLSurface")
+	void MouseDown(FHHTMLBrowser BrowserHandle, ESteamHTMLMouseButton MouseButton) { QueueEvent(BrowserHandle, EInputType::MouseDown, (int32)MouseButton); }
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|HTMLSurface")
+	void MouseUp(FHHTMLBrowser BrowserHandle, ESteamHTMLMouseButton MouseButton) { QueueEvent(BrowserHandle, EInputType::MouseUp, (int32)MouseButton); }
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|HTMLSurface")
+	void MouseDoubleClick(FHHTMLBrowser BrowserHandle, ESteamHTMLMouseButton MouseButton) { QueueEvent(BrowserHandle, EInputType::MouseDoubleClick, (int32)MouseButton); }
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|HTMLSurface")
+	void KeyDown(FHHTMLBrowser BrowserHandle, int32 NativeKeyCode, ESteamHTMLKeyModifiers HTMLKeyModifiers) { QueueEvent(BrowserHandle, EInputType::KeyDown, NativeKeyCode, (int32)HTMLKeyModifiers); }
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|HTMLSurface")
+	void KeyUp(FHHTMLBrowser BrowserHandle, int32 NativeKeyCode, ESteamHTMLKeyModifiers HTMLKeyModifiers) { QueueEvent(BrowserHandle, EInputType::KeyUp, NativeKeyCode, (int32)HTMLKeyModifiers); }
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|HTMLSurface")
+	void KeyChar(FHHTMLBrowser BrowserHandle, int32 UnicodeChar, ESteamHTMLKeyModifiers HTMLKeyModifiers) { QueueEvent(BrowserHandle, EInputType::KeyChar, UnicodeChar, (int32)HTMLKeyModifiers); }
+
+	/**
+	 * Sends the queued input of a browser right away instead of at the end of the frame.
+	 *
+	 * @param FHHTMLBrowser BrowserHandle - The handle of the surface.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|HTMLSurface")
+	void Flush(FHHTMLBrowser BrowserHandle);
+
+	/**
+	 * Drops the queued input of a browser, call it before RemoveBrowser.
+	 *
+	 * @param FHHTMLBrowser BrowserHandle - The handle of the surface.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|HTMLSurface")
+	void DiscardInput(FHHTMLBrowser BrowserHandle) { m_Browsers.Remove(BrowserHandle); }
+
+protected:
+private:
+	enum class EInputType : uint8
+	{
+		MouseMove,
+		MouseWheel,
+		MouseDown,
+		MouseUp,
+		MouseDoubleClick,
+		KeyDown,
+		KeyUp,
+		KeyChar
+	};
+
+	struct FInputEvent
+	{
+		EInputType Type;
+		int32 A;  // x, wheel delta, mouse button or key
+		int32 B;  // y or key modifiers
+	};
+
+	struct FBrowserInput
+	{
+		TArray<FInputEvent> Events;
+		FIntPoint LastSentPosition;  // Moves to where the cursor already is aren't sent
+
+		FBrowserInput() :
+			LastSentPosition(-1, -1) {}
+	};
+
+	void QueueEvent(HHTMLBrowser BrowserHandle, EInputType Type, int32 A, int32 B = 0);
+	void SendEvents(HHTMLBrowser BrowserHandle, FBrowserInput& Input);
+
+	bool Tick(float DeltaTime);
+
+	TMap<HHTMLBrowser, FBrowserInput> m_Browsers;
+	FDelegateHandle m_TickHandle;
+};
@@ -21,7 +21,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_SixParams(FOnHTMLHorizontalScrollDelegate, FH
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHTMLJSAlertDelegate, FHHTMLBrowser, BrowserHandle, FString, Message);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHTMLJSConfirmDelegate, FHHTMLBrowser, BrowserHandle, FString, Message);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnHTMLLinkAtPositionDelegate, FHHTMLBrowser, BrowserHandle, FString, URL, bool, bInput, bool, bLiveLink);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_EightParams(FOnHTMLNeedsPaintDelegate, FHHTMLBrowser, BrowserHandle, FString, BGRA, FIntPoint, Size, FIntPoint, Update, FIntPoint, UpdateSize, FIntPoint, ScrollPosition, float, PageScale, int32, PageSerial);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_SevenParams(FOnHTMLNeedsPaintDelegate, FHHTMLBrowser, BrowserHandle, FIntPoint, Size, FIntPoint, Update, FIntPoint, UpdateSize, FIntPoint, ScrollPosition, float, PageScale, int32, PageSerial);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnHTMLNewWindowDelegate, FHHTMLBrowser, BrowserHandle, FString, URL, FIntPoint, Position, FIntPoint, Size);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHTMLOpenLinkInNewTabDelegate, FHHTMLBrowser, BrowserHandle, FString, URL);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnHTMLSearchResultsDelegate, FHHTMLBrowser, BrowserHandle, int32, Results, int32, CurrentMatch);
@@ -470,7 +470,7 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|Friends", meta = (DisplayName = "OnHTMLLinkAtPosition"))
 	FOnHTMLLinkAtPositionDelegate m_OnHTMLLinkAtPosition;
 
-	/** Called when a browser surface has a pending paint. This is where you get the actual image data to render to the screen. */
+	/** Called when a browser surface has a pending paint. The pixels can't be passed to Blueprint, use a USteamHTMLSurfaceComponent to render the surface to a texture. */
 	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|Friends", meta = (DisplayName = "OnHTMLNeedsPaint"))
 	FOnHTMLNeedsPaintDelegate m_OnHTMLNeedsPaint;
 
@@ -0,0 +1,78 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "Containers/Queue.h"
+#include "CoreMinimal.h"
+#include "Engine/Texture2D.h"
+#include "Steam.h"
+#include "SteamStructs.h"
+
+#include "SteamHTMLSurfaceComponent.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnHTMLSurfaceTextureCreatedDelegate, UTexture2D*, Texture);
+
+/**
+ * Renders an HTML surface browser into a texture.
+ * Every HTML_NeedsPaint_t only uploads the rectangle that changed with UpdateTextureRegions, the texture is only recreated when the browser is resized.
+ * Create the browser with USteamHTMLSurface::CreateBrowser and hand its handle to SetBrowser once it's ready.
+ */
+UCLASS(ClassGroup = (SteamBridge), meta = (BlueprintSpawnableComponent))
+class STEAMBRIDGE_API USteamHTMLSurfaceComponent final : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	USteamHTMLSurfaceComponent();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/**
+	 * Sets the browser to render. Its next paint recreates the texture.
+	 *
+	 * @param FHHTMLBrowser BrowserHandle - The handle from HTML_BrowserReady_t.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|HTMLSurface")
+	void SetBrowser(FHHTMLBrowser BrowserHandle);
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|HTMLSurface")
+	FHHTMLBrowser GetBrowser() const { return m_BrowserHandle; }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|HTMLSurface")
+	UTexture2D* GetTexture() const { return m_Texture; }
+
+	/** Called when the texture was created or recreated because the browser was resized. Set it on the material that displays the surface. */
+	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|HTMLSurface", meta = (DisplayName = "OnTextureCreated"))
+	FOnHTMLSurfaceTextureCreatedDelegate m_OnTextureCreated;
+
+protected:
+private:
+	/** A copy of a dirty rectangle that's alive until the render thread uploaded it. */
+	struct FPaintBuffer
+	{
+		FUpdateTextureRegion2D Region;
+		TArray<uint8> Pixels;
+	};
+
+	/** Paint buffers the render thread handed back, shared with its cleanup callbacks so buffers in flight can outlive the component. */
+	struct FPaintBufferPool
+	{
+		~FPaintBufferPool();
+
+		TQueue<FPaintBuffer*, EQueueMode::Mpsc> FreeBuffers;
+	};
+
+	void RecreateTexture(int32 Width, int32 Height);
+	void UploadRegion(const uint8* BGRA, int32 Pitch, int32 X, int32 Y, int32 Width, int32 Height);
+
+	STEAM_CALLBACK_MANUAL(USteamHTMLSurfaceComponent, OnHTMLNeedsPaint, HTML_NeedsPaint_t, OnHTMLNeedsPaintCallback);
+
+	UPROPERTY(Transient)
+	UTexture2D* m_Texture;
+
+	FHHTMLBrowser m_BrowserHandle;
+	TSharedRef<FPaintBufferPool, ESPMode::ThreadSafe> m_PaintBuffers;
+};
@@ -10,6 +10,8 @@
 
 #include "SteamHTTP.generated.h"
 
+class FSteamHTTPRequest;
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FiveParams(FOnHTTPRequestCompletedDelegate, FHTTPRequestHandle, RequestHandle, int64, ContextValue, bool, bRequestSuccessful, ESteamHTTPStatus::Type, HTTPStatus, int32, BodySize);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnHTTPRequestDataReceivedDelegate, FHTTPRequestHandle, RequestHandle, int64, ContextValue, int32, Offset, int32, BytesReceived);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHTTPRequestHeadersReceivedDelegate, FHTTPRequestHandle, RequestHandle, int64, ContextValue);
@@ -99,7 +101,7 @@ public:
 	 * This is only for HTTP requests which were sent with SendHTTPRequest. Use GetHTTPStreamingResponseBodyData if you're using streaming HTTP requests via SendHTTPRequestAndStreamResponse.
 	 *
 	 * @param FHTTPRequestHandle RequestHandle - The request handle to get the response body data for.
-	 * @param uint8 & BodyDataBuffer - The buffer where the data will be copied into.
+	 * @param TArray<uint8> & BodyDataBuffer - The buffer where the data will be copied into, sized with GetHTTPResponseBodySize.
 	 * @return bool - Returns true upon success indicating that pBodyDataBuffer has been filled with the body data.
 	 * Otherwise, returns false under the following conditions:
 	 * hRequest was invalid.
@@ -109,7 +111,7 @@ public:
 	 * unBufferSize is not the same size that was provided by GetHTTPResponseBodySize.
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|HTTP")
-	bool GetHTTPResponseBodyData(FHTTPRequestHandle RequestHandle, uint8& BodyDataBuffer) const { return SteamHTTP()->GetHTTPResponseBodyData(RequestHandle, &BodyDataBuffer, MAX_uint32); }
+	bool GetHTTPResponseBodyData(FHTTPRequestHandle RequestHandle, TArray<uint8>& BodyDataBuffer) const;
 
 	/**
 	 * Gets the size of the body data from an HTTP response.
@@ -153,7 +155,7 @@ public:
 	 *
 	 * @param FHTTPRequestHandle RequestHandle - The request handle to get the response header value for.
 	 * @param const FString & HeaderName - The header name to get the header value for.
-	 * @param uint8 & HeaderValueBuffer - The buffer where the value will be copied into.
+	 * @param FString & HeaderValue - The header value, sized with GetHTTPResponseHeaderSize.
 	 * @return bool - Returns true upon success indicating that pHeaderValueBuffer has been filled with the header value.
 	 * Otherwise, returns false under the following conditions:
 	 * hRequest was invalid.
@@ -164,7 +166,7 @@ public:
 	 * unBufferSize is not large enough to hold the value.
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|HTTP")
-	bool GetHTTPResponseHeaderValue(FHTTPRequestHandle RequestHandle, const FString& HeaderName, uint8& HeaderValueBuffer) const { return SteamHTTP()->GetHTTPResponseHeaderValue(RequestHandle, TCHAR_TO_UTF8(*HeaderName), &HeaderValueBuffer, MAX_uint32); }
+	bool GetHTTPResponseHeaderValue(FHTTPRequestHandle RequestHandle, const FString& HeaderName, FString& HeaderValue) const;
 
 	/**
 	 * Gets the body data from a streaming HTTP response.
@@ -174,7 +176,8 @@ public:
 	 *
 	 * @param FHTTPRequestHandle RequestHandle - The request handle to get the response body data for.
 	 * @param int32 Offset - This must be the offset provided by HTTPRequestDataReceived_t.
-	 * @param uint8 & BodyDataBuffer - Returns the data by copying it into this buffer.
+	 * @param int32 BytesReceived - This must be the number of bytes provided by HTTPRequestDataReceived_t.
+	 * @param TArray<uint8> & BodyDataBuffer - Returns the data by copying it into this buffer.
 	 * @return bool - Returns true upon success indicating that pBodyDataBuffer has been filled with the body data.
 	 * Otherwise, returns false under the following conditions:
 	 * hRequest was invalid.
@@ -184,7 +187,7 @@ public:
 	 * unBufferSize is not the same size that was provided by HTTPRequestDataReceived_t.
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|HTTP")
-	bool GetHTTPStreamingResponseBodyData(FHTTPRequestHandle RequestHandle, int32 Offset, uint8& BodyDataBuffer) const { return SteamHTTP()->GetHTTPStreamingResponseBodyData(RequestHandle, Offset, &BodyDataBuffer, MAX_uint32); }
+	bool GetHTTPStreamingResponseBodyData(FHTTPRequestHandle RequestHandle, int32 Offset, int32 BytesReceived, TArray<uint8>& BodyDataBuffer) const;
 
 	/**
 	 * Prioritizes a request which has already been sent by moving it at the front of the queue.
@@ -366,7 +369,7 @@ public:
 	 *
 	 * @param FHTTPRequestHandle RequestHandle - The request handle to set the post body on.
 	 * @param const FString & ContentType - Sets the value of the calls "content-type" http header.
-	 * @param uint8 & Body - The raw POST body data to set.
+	 * @param const TArray<uint8> & Body - The raw POST body data to set, Steam keeps its own copy.
 	 * @return bool - Returns true upon success indicating that the content-type field and the body data have been set.
 	 * Otherwise, returns false under the following conditions:
 	 * hRequest was invalid.
@@ -374,7 +377,7 @@ public:
 	 * A POST body has already been set for this request either via this function or with SetHTTPRequestGetOrPostParameter.
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|HTTP")
-	bool SetHTTPRequestRawPostBody(FHTTPRequestHandle RequestHandle, const FString& ContentType, uint8& Body) const { return SteamHTTP()->SetHTTPRequestRawPostBody(RequestHandle, TCHAR_TO_UTF8(*ContentType), &Body, MAX_uint8); }
+	bool SetHTTPRequestRawPostBody(FHTTPRequestHandle RequestHandle, const FString& ContentType, const TArray<uint8>& Body) const { return SteamHTTP()->SetHTTPRequestRawPostBody(RequestHandle, TCHAR_TO_UTF8(*ContentType), const_cast<uint8*>(Body.GetData()), Body.Num()); }
 
 	/**
 	 * Sets that the HTTPS request should require verified SSL certificate via machines certificate trust store.
@@ -417,6 +420,14 @@ public:
 
 protected:
 private:
+	friend class FSteamHTTPRequest;
+
+	// Requests sent with FSteamHTTPRequest, kept alive until their call result ran
+	TArray<TSharedRef<FSteamHTTPRequest>> m_PendingRequests;
+
+	// Finished requests are freed later, their call result is still running when they finish
+	TArray<TSharedRef<FSteamHTTPRequest>> m_FinishedRequests;
+
 	STEAM_CALLBACK_MANUAL(USteamHTTP, OnHTTPRequestCompleted, HTTPRequestCompleted_t, OnHTTPRequestCompletedCallback);
 	STEAM_CALLBACK_MANUAL(USteamHTTP, OnHTTPRequestDataReceived, HTTPRequestDataReceived_t, OnHTTPRequestDataReceivedCallback);
 	STEAM_CALLBACK_MANUAL(USteamHTTP, OnHTTPRequestHeadersReceived, HTTPRequestHeadersReceived_t, OnHTTPRequestHeadersReceivedCallback);
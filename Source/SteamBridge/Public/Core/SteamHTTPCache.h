@@ -0,0 +1,88 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "Async/Future.h"
+#include "CoreMinimal.h"
+#include "Core/SteamHTTPRequest.h"
+#include "Steam.h"
+#include "UObject/NoExportTypes.h"
+
+#include "SteamHTTPCache.generated.h"
+
+/**
+ * An on-disk cache for GET requests sent through ISteamHTTP, for endpoints like configs and catalogs that are fetched on every launch.
+ * Responses that came with an ETag or Last-Modified header are stored under Saved/SteamBridge/HTTPCache. The next request for the URL with the same headers
+ * sends If-None-Match/If-Modified-Since and a 304 is answered with the stored body, so unchanged responses are never downloaded twice.
+ * The cache is limited to USteamBridgeSettings::HTTPCacheMaxBytes, least recently used responses are deleted first.
+ */
+UCLASS()
+class STEAMBRIDGE_API USteamHTTPCache final : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	USteamHTTPCache();
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore", meta = (DisplayName = "Steam HTTP Cache", CompactNodeTitle = "SteamHTTPCache"))
+	static USteamHTTPCache* GetSteamHTTPCache() { return USteamHTTPCache::StaticClass()->GetDefaultObject<USteamHTTPCache>(); }
+
+	/**
+	 * Sends a GET request, conditional if the URL is cached.
+	 * If the request fails outright (e.g. while offline) a cached response is returned instead, check FSteamHTTPResponse::bFromCache.
+	 *
+	 * @param const FString & URL - The absolute URL.
+	 * @param const TMap<FString, FString> & Headers - Extra request headers. Responses are cached per set of headers, e.g. per Authorization.
+	 * @return TFuture<FSteamHTTPResponse> - Set on the game thread. A 304 is reported as 200 with the cached body and bFromCache set.
+	 */
+	TFuture<FSteamHTTPResponse> Get(const FString& URL, const TMap<FString, FString>& Headers = TMap<FString, FString>());
+
+	/** Deletes the cached responses of a URL, for every set of request headers. */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|HTTP")
+	void Invalidate(const FString& URL);
+
+	/** Deletes every cached response. */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|HTTP")
+	void Clear();
+
+	/** Whether the response of a URL requested without extra headers is cached. */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|HTTP")
+	bool IsCached(const FString& URL) { LoadIndex(); return m_Entries.Contains(URL); }
+
+	/** The bytes of response bodies on disk. */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|HTTP")
+	int64 GetCacheSize() { LoadIndex(); return m_TotalBytes; }
+
+protected:
+private:
+	struct FEntry
+	{
+		FString ETag;
+		FString LastModified;
+		int64 Size;
+		uint64 LastUsed;
+
+		friend FArchive& operator<<(FArchive& Ar, FEntry& Entry) { return Ar << Entry.ETag << Entry.LastModified << Entry.Size << Entry.LastUsed; }
+	};
+
+	void Fetch(const FString& URL, const FString& Key, const TMap<FString, FString>& Headers, bool bConditional, const TSharedRef<TPromise<FSteamHTTPResponse>>& Promise);
+	void HandleResponse(const FString& URL, const FString& Key, const TMap<FString, FString>& Headers, bool bConditional, const TSharedRef<TPromise<FSteamHTTPResponse>>& Promise, FSteamHTTPResponse&& Response);
+
+	// Entries are keyed by URL and a hash of the request headers, see MakeKey
+	bool ReadCachedBody(const FString& Key, TArray<uint8>& Body);
+	void Store(const FString& Key, const FSteamHTTPResponse& Response);
+	void RemoveEntry(const FString& Key);
+	void EvictToFit(int64 MaxBytes);
+
+	void LoadIndex();
+	void SaveIndex();
+
+	static FString GetCacheDir();
+	static FString MakeKey(const FString& URL, const TMap<FString, FString>& Headers);
+	static FString GetBodyPath(const FString& Key);
+
+	TMap<FString, FEntry> m_Entries;
+	int64 m_TotalBytes;
+	uint64 m_UseCounter;
+	bool m_bIndexLoaded;
+};
@@ -0,0 +1,139 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "Async/Future.h"
+#include "CoreMinimal.h"
+#include "Misc/Optional.h"
+#include "Steam.h"
+#include "SteamEnums.h"
+
+/** The result of FSteamHTTPRequest::Send. */
+struct FSteamHTTPResponse
+{
+	bool bSuccessful;  // false if the request couldn't be sent, timed out or was cancelled, StatusCode is e_Invalid then
+	bool bTimedOut;
+	bool bFromCache;  // Served by USteamHTTPCache without downloading the body
+	ESteamHTTPStatus::Type StatusCode;
+	TArray<uint8> Body;  // The buffer passed to Send, filled in place. Empty for SendAndStream
+	TMap<FString, FString> Headers;  // Only the headers asked for with CaptureResponseHeader that were in the response
+
+	FSteamHTTPResponse() :
+		bSuccessful(false), bTimedOut(false), bFromCache(false), StatusCode(ESteamHTTPStatus::e_Invalid) {}
+};
+
+/** Receives a streamed response body in order, one chunk at a time. The view is only valid for the call. Return false to cancel the request. */
+using FSteamHTTPStreamSink = TFunction<bool(TArrayView<const uint8>)>;
+
+/**
+ * An HTTP request sent through ISteamHTTP. Build it with the setters, then Send it and wait on the returned future.
+ * Every request waits on its own HTTPRequestCompleted_t call result so any number of them can be in flight, and the request handle is released once it finished.
+ * USteamHTTP keeps a sent request alive until it completed, the caller doesn't need to hold on to it.
+ *
+ *	FSteamHTTPRequest::Create(ESteamHTTPMethod::GET, TEXT("https://example.com/news.json"))
+ *		->SetHeader(TEXT("Accept"), TEXT("application/json"))
+ *		.Send()
+ *		.Next([](const FSteamHTTPResponse& Response) { ... });
+ */
+class STEAMBRIDGE_API FSteamHTTPRequest final : public TSharedFromThis<FSteamHTTPRequest>
+{
+public:
+	enum class EPriority : uint8
+	{
+		Normal,
+		High,  // Moved to the front of the queue with PrioritizeHTTPRequest
+		Low  // Moved to the back of the queue with DeferHTTPRequest
+	};
+
+	static TSharedRef<FSteamHTTPRequest> Create(ESteamHTTPMethod Method, const FString& AbsoluteURL);
+
+	~FSteamHTTPRequest();
+
+	FSteamHTTPRequest& SetHeader(const FString& Name, const FString& Value);
+	FSteamHTTPRequest& SetParameter(const FString& Name, const FString& Value);
+
+	/** Sets the raw body of a POST, PUT or PATCH request. Steam copies the data so the view only has to stay valid for the call. */
+	FSteamHTTPRequest& SetBody(const FString& ContentType, TArrayView<const uint8> Body);
+
+	FSteamHTTPRequest& SetTimeout(int32 Milliseconds);
+	FSteamHTTPRequest& SetCookieContainer(HTTPCookieContainerHandle CookieContainer);
+
+	/** Reads a response header into FSteamHTTPResponse::Headers when the request completes. */
+	FSteamHTTPRequest& CaptureResponseHeader(const FString& Name);
+
+	/**
+	 * Sends the request.
+	 *
+	 * @param TArray<uint8> && BodyBuffer - The buffer the response body is read into. Pass a buffer you're done with to reuse its allocation.
+	 * @param EPriority Priority - Where the request goes in Steam's queue.
+	 * @return TFuture<FSteamHTTPResponse> - Set on the game thread once the request completed.
+	 */
+	TFuture<FSteamHTTPResponse> Send(TArray<uint8>&& BodyBuffer = TArray<uint8>(), EPriority Priority = EPriority::Normal);
+
+	/**
+	 * Sends the request with SendHTTPRequestAndStreamResponse and hands the body to Sink as it arrives instead of buffering it.
+	 * Every chunk is read into one buffer that's reused for the whole response, so memory stays at the size of the largest chunk.
+	 *
+	 * @param FSteamHTTPStreamSink && Sink - Called on the game thread for every chunk. It's destroyed before the future is set.
+	 * @param EPriority Priority - Where the request goes in Steam's queue.
+	 * @return TFuture<FSteamHTTPResponse> - Set on the game thread once the request completed, the body was streamed or the sink cancelled.
+	 */
+	TFuture<FSteamHTTPResponse> SendAndStream(FSteamHTTPStreamSink&& Sink, EPriority Priority = EPriority::Normal);
+
+	/** Changes the priority of a request that was sent and is still queued. */
+	bool SetPriority(EPriority Priority);
+
+	/** Releases the request, Steam drops it if it's still queued or running. The future is set as unsuccessful. Called from the sink, the request is cancelled once the sink returned. */
+	void Cancel();
+
+	HTTPRequestHandle GetHandle() const { return m_Handle; }
+	bool IsInFlight() const { return m_bInFlight; }
+
+protected:
+private:
+	friend class USteamHTTP;
+
+	FSteamHTTPRequest();
+
+	bool SendInternal(bool bStream, EPriority Priority);
+	void OnDataReceived(uint32 Offset, uint32 BytesReceived);
+	void OnRequestCompleted(HTTPRequestCompleted_t* pParam, bool bIOFailure);
+	void Finish(FSteamHTTPResponse&& Response);
+
+	HTTPRequestHandle m_Handle;
+	CCallResult<FSteamHTTPRequest, HTTPRequestCompleted_t> m_CallResult;
+	TOptional<TPromise<FSteamHTTPResponse>> m_Promise;  // Only constructed once the request is sent, an unset promise asserts when it's destroyed
+	TArray<uint8> m_BodyBuffer;
+	TArray<FString> m_CapturedHeaders;
+	FSteamHTTPStreamSink m_StreamSink;
+	int64 m_StreamOffset;  // Bytes handed to m_StreamSink so far
+	bool m_bInFlight;
+	bool m_bInSink;  // Cancel only marks the request while m_StreamSink runs, finishing destroys the sink
+	bool m_bCancelRequested;
+};
+
+/**
+ * A stream sink that writes the response to a file on a worker thread while the next chunk is received.
+ * It copies each chunk into its own buffer before writing it, so at most two chunks are in memory at once.
+ *
+ *	Request->SendAndStream(FSteamHTTPFileWriter::MakeSink(FPaths::ProjectSavedDir() / TEXT("Patch.pak")));
+ */
+class STEAMBRIDGE_API FSteamHTTPFileWriter final
+{
+public:
+	/** Creates a writer for FilePath that's owned by the returned sink and closes the file once the sink was destroyed. */
+	static FSteamHTTPStreamSink MakeSink(const FString& FilePath);
+
+	explicit FSteamHTTPFileWriter(const FString& FilePath);
+	~FSteamHTTPFileWriter();
+
+	/** Waits for the previous chunk to be written, then starts writing this one. Returns false if the file couldn't be opened or a write failed. */
+	bool Write(TArrayView<const uint8> Data);
+
+protected:
+private:
+	TUniquePtr<FArchive> m_File;
+	TArray<uint8> m_WritingChunk;
+	TFuture<void> m_Write;
+	bool m_bError;
+};
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Steam.h"
 #include "SteamEnums.h"
+#include "SteamBridgeUtils.h"
 #include "SteamStructs.h"
 #include "UObject/NoExportTypes.h"
 
@@ -109,7 +110,7 @@ public:
 	 * Returns a new result handle via pResultHandle.
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|Inventory")
-	bool DeserializeResult(FSteamInventoryResult& ResultHandle, TArray<uint8> Buffer) const { return SteamInventory()->DeserializeResult(&ResultHandle.Value, Buffer.GetData(), Buffer.Num(), false); }
+	bool DeserializeResult(FSteamInventoryResult& ResultHandle, const TArray<uint8>& Buffer) const { return SteamInventory()->DeserializeResult(&ResultHandle.Value, Buffer.GetData(), Buffer.Num(), false); }
 
 	/**
 	 * Destroys a result handle and frees all associated memory.
@@ -527,6 +528,9 @@ public:
 
 protected:
 private:
+	mutable FSteamScratchBuffer m_ScratchBuffer;
+	mutable TArray<SteamItemDetails_t> m_ResultItemsScratch;
+
 	STEAM_CALLBACK_MANUAL(USteamInventory, OnSteamInventoryDefinitionUpdate, SteamInventoryDefinitionUpdate_t, OnSteamInventoryDefinitionUpdateCallback);
 	STEAM_CALLBACK_MANUAL(USteamInventory, OnSteamInventoryEligiblePromoItemDefIDs, SteamInventoryEligiblePromoItemDefIDs_t, OnSteamInventoryEligiblePromoItemDefIDsCallback);
 	STEAM_CALLBACK_MANUAL(USteamInventory, OnSteamInventoryFullUpdate, SteamInventoryFullUpdate_t, OnSteamInventoryFullUpdateCallback);
@@ -0,0 +1,138 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Steam.h"
+#include "SteamEnums.h"
+#include "SteamStructs.h"
+#include "UObject/NoExportTypes.h"
+
+#include "SteamInventoryMirror.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSteamInventoryMirrorUpdatedDelegate, bool, bFullUpdate, const TArray<FSteamItemInstanceID>&, ChangedItems);
+
+/**
+ * A local copy of the current user's inventory that is kept up to date from SteamInventoryFullUpdate_t and SteamInventoryResultReady_t.
+ * Items are stored as columns indexed by slot, with O(1) lookups by instance ID and by item definition, so it can be queried every frame without touching the Steam API.
+ */
+UCLASS()
+class STEAMBRIDGE_API USteamInventoryMirror final : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	USteamInventoryMirror();
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore", meta = (DisplayName = "Steam Inventory Mirror", CompactNodeTitle = "SteamInventoryMirror"))
+	static USteamInventoryMirror* GetSteamInventoryMirror() { return USteamInventoryMirror::StaticClass()->GetDefaultObject<USteamInventoryMirror>(); }
+
+	/**
+	 * Starts mirroring the inventory and requests it with GetAllItems.
+	 * Any inventory result that belongs to the current user (e.g. from GenerateItems, ExchangeItems or ConsumeItem) is applied to the mirror when it's ready.
+	 *
+	 * @return bool - false if GetAllItems failed.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|Inventory")
+	bool StartMirroring();
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|Inventory")
+	void StopMirroring();
+
+	/**
+	 * Requests the full inventory again. The mirror is replaced when the result arrives.
+	 *
+	 * @return bool - false if GetAllItems failed.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|Inventory")
+	bool Refresh();
+
+	/**
+	 * Gets a mirrored item.
+	 *
+	 * @param FSteamItemInstanceID ItemID - The item instance.
+	 * @param FSteamItemDetails & Item - Returns the item.
+	 * @return bool - true if the item is in the inventory.
+	 */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	bool GetItem(FSteamItemInstanceID ItemID, FSteamItemDetails& Item) const;
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	bool HasItem(FSteamItemInstanceID ItemID) const { return m_IndexByInstance.Contains(ItemID); }
+
+	/**
+	 * Gets the total quantity of every stack of an item definition.
+	 *
+	 * @param FSteamItemDef Definition - The item definition.
+	 * @return int32 - The total quantity, 0 if the user has none.
+	 */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	int32 GetDefinitionQuantity(FSteamItemDef Definition) const;
+
+	/**
+	 * Gets every stack of an item definition.
+	 *
+	 * @param FSteamItemDef Definition - The item definition.
+	 * @param TArray<FSteamItemInstanceID> & ItemIDs - Returns the item instances.
+	 * @return int32 - The number of stacks.
+	 */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	int32 GetDefinitionItems(FSteamItemDef Definition, TArray<FSteamItemInstanceID>& ItemIDs) const;
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	int32 GetNumItems() const { return m_InstanceIDs.Num(); }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	bool HasFullUpdate() const { return m_bHasFullUpdate; }
+
+	/** Slot of an item in the columns below or INDEX_NONE. Slots change when items are removed. */
+	int32 FindSlot(SteamItemInstanceID_t ItemID) const;
+
+	const TArray<SteamItemInstanceID_t>& GetInstanceIDColumn() const { return m_InstanceIDs; }
+	const TArray<SteamItemDef_t>& GetDefinitionColumn() const { return m_Definitions; }
+	const TArray<uint16>& GetQuantityColumn() const { return m_Quantities; }
+	const TArray<uint16>& GetFlagsColumn() const { return m_Flags; }
+
+	/** Called after a result was applied. ChangedItems is empty for full updates. */
+	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|Inventory", meta = (DisplayName = "OnMirrorUpdated"))
+	FOnSteamInventoryMirrorUpdatedDelegate m_OnMirrorUpdated;
+
+protected:
+private:
+	struct FDefinitionBucket
+	{
+		int32 TotalQuantity = 0;
+		TArray<SteamItemInstanceID_t, TInlineAllocator<4>> InstanceIDs;
+	};
+
+	bool ReadResultItems(SteamInventoryResult_t ResultHandle);
+	void ApplyFullUpdate();
+	void ApplyChangedItems();
+
+	void AddItem(const SteamItemDetails_t& Details);
+	void RemoveSlot(int32 Slot);
+	void Reset();
+
+	UFUNCTION()
+	void HandleFullUpdate(FSteamInventoryResult ResultHandle);
+
+	UFUNCTION()
+	void HandleResultReady(FSteamInventoryResult ResultHandle, ESteamResult Result);
+
+	// Columns, one entry per item slot
+	TArray<SteamItemInstanceID_t> m_InstanceIDs;
+	TArray<SteamItemDef_t> m_Definitions;
+	TArray<uint16> m_Quantities;
+	TArray<uint16> m_Flags;
+
+	TMap<SteamItemInstanceID_t, int32> m_IndexByInstance;
+	TMap<SteamItemDef_t, FDefinitionBucket> m_Buckets;
+
+	TArray<SteamItemDetails_t> m_ResultItems;
+	TArray<FSteamItemInstanceID> m_ChangedItems;
+
+	SteamInventoryResult_t m_RefreshHandle;
+	SteamInventoryResult_t m_LastFullUpdateHandle;
+	bool m_bMirroring;
+	bool m_bHasFullUpdate;
+};
@@ -0,0 +1,117 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Steam.h"
+#include "SteamEnums.h"
+#include "SteamStructs.h"
+#include "UObject/NoExportTypes.h"
+
+#include "SteamInventoryTransaction.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnSteamInventoryTransactionCompletedDelegate, bool, bSuccess, int32, NumFailedOperations, const TArray<FSteamItemDetails>&, Items);
+
+/**
+ * Collects GenerateItems, ExchangeItems, ConsumeItem and TransferItemQuantity operations and submits them together.
+ * Every inventory result the transaction creates is tracked until SteamInventoryResultReady_t and destroyed automatically.
+ */
+UCLASS(BlueprintType)
+class STEAMBRIDGE_API USteamInventoryTransaction final : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	USteamInventoryTransaction();
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|Inventory")
+	static USteamInventoryTransaction* CreateInventoryTransaction();
+
+	/**
+	 * Grants an item to the current user, for developers only. Every generate in the transaction is sent in one GenerateItems call.
+	 *
+	 * @param FSteamItemDef ItemDef - The item to grant.
+	 * @param int32 Quantity - The quantity to grant.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|Inventory")
+	void AddGenerateItem(FSteamItemDef ItemDef, int32 Quantity = 1);
+
+	/**
+	 * Exchanges items for one item using a recipe from its "exchange" attribute.
+	 *
+	 * @param FSteamItemDef ItemDef - The item to create.
+	 * @param const TMap<FSteamItemInstanceID, int32> & ItemsDestroyed - The items and quantities that are consumed by the exchange.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|Inventory")
+	void AddExchange(FSteamItemDef ItemDef, const TMap<FSteamItemInstanceID, int32>& ItemsDestroyed);
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|Inventory")
+	void AddConsumeItem(FSteamItemInstanceID ItemID, int32 Quantity = 1);
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|Inventory")
+	void AddTransferItemQuantity(FSteamItemInstanceID ItemIdSource, int32 Quantity, FSteamItemInstanceID ItemIdDest);
+
+	/**
+	 * Issues every operation. OnTransactionCompleted is called once all of their results are ready.
+	 *
+	 * @return bool - false if the transaction is empty or was already submitted.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|Inventory")
+	bool Submit();
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	int32 GetNumOperations() const { return (m_GenerateDefs.Num() > 0 ? 1 : 0) + m_Exchanges.Num() + m_Consumes.Num() + m_Transfers.Num(); }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	bool IsPending() const { return m_PendingResults.Num() > 0; }
+
+	/** Called with every item the transaction changed once all of its results are ready. */
+	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|Inventory", meta = (DisplayName = "OnTransactionCompleted"))
+	FOnSteamInventoryTransactionCompletedDelegate m_OnTransactionCompleted;
+
+protected:
+private:
+	struct FExchange
+	{
+		SteamItemDef_t Generate;
+		int32 DestroyStart;
+		int32 DestroyNum;
+	};
+
+	struct FConsume
+	{
+		SteamItemInstanceID_t ItemID;
+		uint32 Quantity;
+	};
+
+	struct FTransfer
+	{
+		SteamItemInstanceID_t Source;
+		uint32 Quantity;
+		SteamItemInstanceID_t Dest;
+	};
+
+	void TrackResult(bool bIssued, SteamInventoryResult_t ResultHandle);
+	void Finish();
+
+	UFUNCTION()
+	void HandleResultReady(FSteamInventoryResult ResultHandle, ESteamResult Result);
+
+	TArray<SteamItemDef_t> m_GenerateDefs;
+	TArray<uint32> m_GenerateQuantities;
+
+	TArray<FExchange> m_Exchanges;
+	TArray<SteamItemInstanceID_t> m_DestroyIDs;
+	TArray<uint32> m_DestroyQuantities;
+
+	TArray<FConsume> m_Consumes;
+	TArray<FTransfer> m_Transfers;
+
+	TArray<SteamInventoryResult_t> m_PendingResults;
+	TArray<SteamInventoryResult_t> m_CompletedResults;
+	TArray<FSteamItemDetails> m_Items;
+	int32 m_NumFailed;
+	bool m_bSubmitted;
+};
@@ -0,0 +1,109 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Steam.h"
+#include "SteamEnums.h"
+#include "SteamStructs.h"
+#include "UObject/NoExportTypes.h"
+
+#include "SteamInventoryVerifier.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSteamInventoryVerificationsCompletedDelegate, const TArray<FSteamInventoryVerification>&, Verifications);
+
+/**
+ * Verifies serialized inventory results (see SerializeResult) sent by many clients.
+ * Blobs are deserialized a batch at a time, their status is polled once per frame and every verification that completed during a frame is reported together.
+ * Uses the game server inventory interface when it's available so it works on dedicated servers.
+ */
+UCLASS()
+class STEAMBRIDGE_API USteamInventoryVerifier final : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	USteamInventoryVerifier();
+	~USteamInventoryVerifier();
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore", meta = (DisplayName = "Steam Inventory Verifier", CompactNodeTitle = "SteamInventoryVerifier"))
+	static USteamInventoryVerifier* GetSteamInventoryVerifier() { return USteamInventoryVerifier::StaticClass()->GetDefaultObject<USteamInventoryVerifier>(); }
+
+	/**
+	 * Queues a serialized inventory result for verification.
+	 *
+	 * @param FSteamID SteamID - The player that sent the result. The result must belong to this player to be verified.
+	 * @param const TArray<uint8> & Buffer - The serialized result.
+	 * @return int32 - The request ID reported back in OnVerificationsCompleted.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|Inventory")
+	int32 QueueVerification(FSteamID SteamID, const TArray<uint8>& Buffer);
+
+	/** Same as above but takes ownership of the buffer instead of copying it. */
+	int32 QueueVerification(FSteamID SteamID, TArray<uint8>&& Buffer);
+
+	/**
+	 * Sets how many results may be deserializing at once.
+	 *
+	 * @param int32 MaxInFlight - The maximum number of pending results.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|Inventory")
+	void SetMaxInFlight(int32 MaxInFlight) { m_MaxInFlight = FMath::Max(1, MaxInFlight); }
+
+	/**
+	 * Results older than an hour report k_EResultExpired. By default they aren't verified.
+	 *
+	 * @param bool bAllow - Whether expired results are accepted.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|Inventory")
+	void SetAllowExpiredResults(bool bAllow) { m_bAllowExpiredResults = bAllow; }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	int32 GetNumPendingVerifications() const { return m_Queue.Num() - m_QueueHead + m_InFlight.Num(); }
+
+	/** Called once per frame with every verification that completed during that frame. */
+	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|Inventory", meta = (DisplayName = "OnVerificationsCompleted"))
+	FOnSteamInventoryVerificationsCompletedDelegate m_OnVerificationsCompleted;
+
+protected:
+private:
+	struct FQueuedBlob
+	{
+		int32 RequestID;
+		uint64 SteamID;
+		TArray<uint8> Buffer;
+	};
+
+	struct FInFlight
+	{
+		int32 RequestID;
+		uint64 SteamID;
+		SteamInventoryResult_t ResultHandle;
+	};
+
+	static ISteamInventory* GetInventoryInterface();
+
+	int32 Enqueue(FSteamID SteamID, TArray<uint8>&& Buffer);
+	bool Tick(float DeltaTime);
+	void IssueDeserializes(ISteamInventory* Inventory);
+	void PollInFlight(ISteamInventory* Inventory);
+	void Complete(ISteamInventory* Inventory, const FInFlight& Request, EResult Status);
+
+	// m_Queue[m_QueueHead..] are waiting to be deserialized, the array is compacted once it's drained
+	TArray<FQueuedBlob> m_Queue;
+	int32 m_QueueHead;
+	TArray<FInFlight> m_InFlight;
+
+	// Buffers of blobs that were already deserialized, reused for the next blobs copied in from Blueprints
+	TArray<TArray<uint8>> m_BufferPool;
+	TArray<SteamItemDetails_t> m_ItemScratch;
+	TArray<FSteamInventoryVerification> m_Completed;
+
+	int32 m_NextRequestID;
+	int32 m_MaxInFlight;
+	bool m_bAllowExpiredResults;
+
+	FDelegateHandle m_TickHandle;
+};
@@ -0,0 +1,192 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Steam.h"
+#include "SteamEnums.h"
+#include "SteamStructs.h"
+#include "UObject/NoExportTypes.h"
+
+#include "SteamItemCatalog.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSteamItemCatalogUpdatedDelegate, bool, bFromCache);
+
+/**
+ * Every item definition and its properties, read once when SteamInventoryDefinitionUpdate_t fires.
+ * The name, type, tags, exchange recipes and prices are parsed into typed columns, repeated strings are interned, and the catalog
+ * is saved to disk so the next session can use it before Steam has delivered the definitions.
+ */
+UCLASS()
+class STEAMBRIDGE_API USteamItemCatalog final : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	USteamItemCatalog();
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore", meta = (DisplayName = "Steam Item Catalog", CompactNodeTitle = "SteamItemCatalog"))
+	static USteamItemCatalog* GetSteamItemCatalog() { return USteamItemCatalog::StaticClass()->GetDefaultObject<USteamItemCatalog>(); }
+
+	/**
+	 * Loads the catalog saved by the last session and rebuilds it whenever the item definitions are updated.
+	 *
+	 * @return bool - true if a catalog is available (from disk or from Steam).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|Inventory")
+	bool StartCatalog();
+
+	/**
+	 * Reads every item definition from Steam and saves the catalog. Called automatically on SteamInventoryDefinitionUpdate_t.
+	 *
+	 * @return bool - false if the item definitions haven't been loaded by Steam yet.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|Inventory")
+	bool Rebuild();
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	bool IsLoaded() const { return m_bLoaded; }
+
+	/** true until the definitions were read from Steam this session. */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	bool IsFromCache() const { return m_bFromCache; }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	void GetDefinitionIDs(TArray<FSteamItemDef>& Definitions) const;
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	bool HasDefinition(FSteamItemDef Definition) const { return m_IndexByDefinition.Contains(Definition); }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	FString GetDefinitionName(FSteamItemDef Definition) const;
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	FString GetDefinitionType(FSteamItemDef Definition) const;
+
+	/**
+	 * Gets any property of an item definition, as returned by GetItemDefinitionProperty.
+	 *
+	 * @param FSteamItemDef Definition - The item definition.
+	 * @param const FString & PropertyName - The property name.
+	 * @param FString & Value - Returns the raw property value.
+	 * @return bool - true if the definition has the property.
+	 */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	bool GetDefinitionProperty(FSteamItemDef Definition, const FString& PropertyName, FString& Value) const;
+
+	/**
+	 * Gets the parsed "tags" property of an item definition. Entry i of Categories belongs to entry i of Values.
+	 *
+	 * @param FSteamItemDef Definition - The item definition.
+	 * @param TArray<FString> & Categories - Returns the tag categories.
+	 * @param TArray<FString> & Values - Returns the tag values.
+	 * @return int32 - The number of tags.
+	 */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	int32 GetDefinitionTags(FSteamItemDef Definition, TArray<FString>& Categories, TArray<FString>& Values) const;
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	bool HasTag(FSteamItemDef Definition, const FString& Category, const FString& Value) const;
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	void FindDefinitionsWithTag(const FString& Category, const FString& Value, TArray<FSteamItemDef>& Definitions) const;
+
+	/**
+	 * Gets the parsed "exchange" property of an item definition. Only item definition materials are returned, tag based materials are skipped.
+	 *
+	 * @param FSteamItemDef Definition - The item definition.
+	 * @param TArray<FSteamItemRecipe> & Recipes - Returns the recipes.
+	 * @return int32 - The number of recipes.
+	 */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	int32 GetExchangeRecipes(FSteamItemDef Definition, TArray<FSteamItemRecipe>& Recipes) const;
+
+	/**
+	 * Gets the price of an item definition parsed from its "price" or "price_category" property.
+	 *
+	 * @param FSteamItemDef Definition - The item definition.
+	 * @param const FString & Currency - The currency code, e.g. USD or VLV for a price category.
+	 * @param int32 & Amount - Returns the price in the currency's smallest unit.
+	 * @return bool - true if the definition has a price in the currency.
+	 */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|Inventory")
+	bool GetPrice(FSteamItemDef Definition, const FString& Currency, int32& Amount) const;
+
+	/** Called after the catalog was loaded from disk or rebuilt from Steam. */
+	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|Inventory", meta = (DisplayName = "OnCatalogUpdated"))
+	FOnSteamItemCatalogUpdatedDelegate m_OnCatalogUpdated;
+
+protected:
+private:
+	struct FRange
+	{
+		int32 Start = 0;
+		int32 Num = 0;
+		friend FArchive& operator<<(FArchive& Ar, FRange& Range) { return Ar << Range.Start << Range.Num; }
+	};
+
+	// Every FString column below is an index into m_Strings
+	struct FStringPair
+	{
+		int32 Key = INDEX_NONE;
+		int32 Value = INDEX_NONE;
+		friend FArchive& operator<<(FArchive& Ar, FStringPair& Pair) { return Ar << Pair.Key << Pair.Value; }
+	};
+
+	struct FRecipeComponent
+	{
+		SteamItemDef_t Definition = 0;
+		int32 Quantity = 0;
+		friend FArchive& operator<<(FArchive& Ar, FRecipeComponent& Component) { return Ar << Component.Definition << Component.Quantity; }
+	};
+
+	struct FPrice
+	{
+		int32 Currency = INDEX_NONE;
+		int32 Amount = 0;
+		friend FArchive& operator<<(FArchive& Ar, FPrice& Price) { return Ar << Price.Currency << Price.Amount; }
+	};
+
+	int32 Intern(const FString& String);
+	int32 FindString(const FString& String) const;
+	int32 FindIndex(SteamItemDef_t Definition) const;
+
+	void ParseTags(const FString& Tags);
+	void ParseExchange(const FString& Exchange);
+	void ParsePrices(const FString& Price);
+
+	void Reset();
+	void SerializeCatalog(FArchive& Ar);
+	bool IsValidCatalog() const;
+	bool LoadFromDisk();
+	void SaveToDisk();
+	FString GetCachePath() const;
+
+	UFUNCTION()
+	void HandleDefinitionUpdate();
+
+	TArray<FString> m_Strings;
+	TMap<FString, int32> m_StringIndices;
+
+	// Columns, one entry per item definition
+	TArray<SteamItemDef_t> m_Definitions;
+	TArray<int32> m_Names;
+	TArray<int32> m_Types;
+	TArray<FRange> m_TagRanges;
+	TArray<FRange> m_RecipeRanges;
+	TArray<FRange> m_PriceRanges;
+	TArray<FRange> m_PropertyRanges;
+
+	TArray<FStringPair> m_Tags;
+	TArray<FRange> m_Recipes;
+	TArray<FRecipeComponent> m_RecipeComponents;
+	TArray<FPrice> m_Prices;
+	TArray<FStringPair> m_Properties;
+
+	TMap<SteamItemDef_t, int32> m_IndexByDefinition;
+
+	FString m_Language;
+	bool m_bLoaded;
+	bool m_bFromCache;
+	bool m_bStarted;
+};
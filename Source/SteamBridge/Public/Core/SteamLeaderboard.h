@@ -0,0 +1,143 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Steam.h"
+#include "SteamEnums.h"
+#include "SteamStructs.h"
+#include "UObject/NoExportTypes.h"
+
+#include "SteamLeaderboard.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSteamLeaderboardRangeCachedDelegate, int32, FirstRank, int32, LastRank);
+
+/**
+ * Caches the global entries of a leaderboard for UIs that scroll through it.
+ * Entries are downloaded a page at a time and decoded in one pass into flat arrays, the cached rank ranges are kept as a sorted list of merged intervals.
+ * Requesting the visible ranks also prefetches the pages around them so scrolling is served from the cache.
+ */
+UCLASS(BlueprintType)
+class STEAMBRIDGE_API USteamLeaderboard final : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	USteamLeaderboard();
+
+	/**
+	 * Creates a cache for a leaderboard.
+	 *
+	 * @param FSteamLeaderboard SteamLeaderboard - A leaderboard handle obtained from FindLeaderboard or FindOrCreateLeaderboard.
+	 * @param int32 PageSize - How many entries are downloaded at once.
+	 * @param int32 MaxDetails - How many details of each entry are kept, up to k_cLeaderboardDetailsMax.
+	 * @return USteamLeaderboard *
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	static USteamLeaderboard* CreateLeaderboard(FSteamLeaderboard SteamLeaderboard, int32 PageSize = 100, int32 MaxDetails = 0);
+
+	/**
+	 * Makes sure a range of ranks is cached. Missing pages are downloaded first, then the pages before and after the range.
+	 * Pages queued by a previous request that are no longer needed are dropped, so this can be called every time the visible rows change.
+	 *
+	 * @param int32 FirstRank - The first visible rank, starting at 1.
+	 * @param int32 LastRank - The last visible rank.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	void RequestRange(int32 FirstRank, int32 LastRank);
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UserStats")
+	bool IsRangeCached(int32 FirstRank, int32 LastRank) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|UserStats")
+	bool GetEntry(int32 Rank, FSteamLeaderboardEntry& Entry) const;
+
+	/**
+	 * Copies the cached entries starting at a rank.
+	 *
+	 * @param int32 FirstRank - The first rank to copy.
+	 * @param int32 Count - The maximum number of entries to copy.
+	 * @param TArray<FSteamLeaderboardEntry> & Entries - The entries, stops at the first rank that isn't cached.
+	 * @return int32 - The number of entries copied.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|UserStats")
+	int32 GetEntries(int32 FirstRank, int32 Count, TArray<FSteamLeaderboardEntry>& Entries) const;
+
+	/** Same as above without copying. The view is invalidated by the next download or Invalidate. */
+	TArrayView<const FSteamLeaderboardEntry> GetEntries(int32 FirstRank, int32 Count) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|UserStats")
+	bool GetEntryDetails(int32 Rank, TArray<int32>& Details) const;
+
+	/** Same as above without copying. */
+	TArrayView<const int32> GetEntryDetails(int32 Rank) const;
+
+	/** The number of entries in the leaderboard, as of the last download. */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UserStats")
+	int32 GetTotalEntryCount() const { return SteamUserStats()->GetLeaderboardEntryCount(m_SteamLeaderboard); }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UserStats")
+	int32 GetNumCachedEntries() const { return m_NumCachedEntries; }
+
+	/**
+	 * Limits how many entries are kept. The ranges furthest from the last requested range are dropped first.
+	 *
+	 * @param int32 MaxCachedEntries - The maximum number of cached entries.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	void SetMaxCachedEntries(int32 MaxCachedEntries);
+
+	/** Drops every cached entry, e.g. after uploading a new score. */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	void Invalidate();
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UserStats")
+	FSteamLeaderboard GetSteamLeaderboard() const { return m_SteamLeaderboard; }
+
+	/** Called when a downloaded range of ranks was added to the cache. */
+	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|UserStats", meta = (DisplayName = "OnRangeCached"))
+	FOnSteamLeaderboardRangeCachedDelegate m_OnRangeCached;
+
+protected:
+private:
+	// A contiguous run of cached ranks, Details holds m_MaxDetails values per entry
+	struct FCachedRange
+	{
+		int32 FirstRank;
+		TArray<FSteamLeaderboardEntry> Entries;
+		TArray<int32> Details;
+
+		int32 LastRank() const { return FirstRank + Entries.Num() - 1; }
+	};
+
+	int32 FindRange(int32 Rank) const;
+	void QueuePage(int32 Page);
+	void DownloadNextPage();
+	void InsertRange(FCachedRange&& NewRange);
+	void EvictRanges();
+
+	void OnScoresDownloaded(LeaderboardScoresDownloaded_t* pParam, bool bIOFailure);
+
+	FSteamLeaderboard m_SteamLeaderboard;
+	int32 m_PageSize;
+	int32 m_MaxDetails;
+	int32 m_MaxCachedEntries;
+
+	// Sorted by FirstRank, never overlapping or adjacent
+	TArray<FCachedRange> m_Ranges;
+	int32 m_NumCachedEntries;
+
+	// Pages waiting to be downloaded, the most important first
+	TArray<int32> m_PageQueue;
+	int32 m_InFlightPage;
+	double m_InFlightTime;
+	bool m_bDiscardInFlight;
+
+	// Only the page this cache asked for completes it, downloads of the same leaderboard made elsewhere never do
+	CCallResult<USteamLeaderboard, LeaderboardScoresDownloaded_t> m_DownloadCall;
+
+	int32 m_RequestedFirstRank;
+	int32 m_RequestedLastRank;
+};
@@ -0,0 +1,117 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Steam.h"
+#include "SteamEnums.h"
+#include "SteamStructs.h"
+#include "UObject/NoExportTypes.h"
+
+#include "SteamLeaderboardResolver.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnSteamLeaderboardResolvedDelegate, const FString&, LeaderboardName, FSteamLeaderboard, SteamLeaderboard, bool, bLeaderboardFound);
+
+/**
+ * Caches leaderboard handles by name for the session so a board only costs one FindLeaderboard round trip.
+ * Lookups of a name that's already being looked up join the pending one, lookups of different names run in parallel.
+ */
+UCLASS()
+class STEAMBRIDGE_API USteamLeaderboardResolver final : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore", meta = (DisplayName = "Steam Leaderboard Resolver", CompactNodeTitle = "SteamLeaderboardResolver"))
+	static USteamLeaderboardResolver* GetSteamLeaderboardResolver() { return USteamLeaderboardResolver::StaticClass()->GetDefaultObject<USteamLeaderboardResolver>(); }
+
+	/**
+	 * Gets the handle of a leaderboard, looking it up with FindLeaderboard if it isn't cached yet.
+	 *
+	 * @param const FString & LeaderboardName - The name of the leaderboard.
+	 * @param FSteamLeaderboard & SteamLeaderboard - The handle if it was cached.
+	 * @return bool - true if the handle was cached. Otherwise OnLeaderboardResolved is called once the lookup finishes, or right away if it couldn't be started.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	bool ResolveLeaderboard(const FString& LeaderboardName, FSteamLeaderboard& SteamLeaderboard);
+
+	/**
+	 * Same as ResolveLeaderboard but creates the leaderboard if it doesn't exist, see FindOrCreateLeaderboard.
+	 *
+	 * @param const FString & LeaderboardName - The name of the leaderboard.
+	 * @param ESteamLeaderboardSortMethod LeaderboardSortMethod - The sort order of the new leaderboard if it's created.
+	 * @param ESteamLeaderboardDisplayType LeaderboardDisplayType - The display type of the new leaderboard if it's created.
+	 * @param FSteamLeaderboard & SteamLeaderboard - The handle if it was cached.
+	 * @return bool - true if the handle was cached. Otherwise OnLeaderboardResolved is called once the lookup finishes, or right away if it couldn't be started.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	bool ResolveOrCreateLeaderboard(const FString& LeaderboardName, ESteamLeaderboardSortMethod LeaderboardSortMethod, ESteamLeaderboardDisplayType LeaderboardDisplayType, FSteamLeaderboard& SteamLeaderboard);
+
+	/** Same as ResolveLeaderboard but calls OnResolved instead of the delegate, right away if the handle is cached. */
+	void ResolveLeaderboard(const FString& LeaderboardName, TFunction<void(FSteamLeaderboard, bool)>&& OnResolved);
+
+	/**
+	 * Gets a leaderboard from the cache without looking it up.
+	 *
+	 * @param const FString & LeaderboardName - The name of the leaderboard.
+	 * @param FSteamLeaderboard & SteamLeaderboard - The handle.
+	 * @param ESteamLeaderboardSortMethod & LeaderboardSortMethod - The sort method of the leaderboard.
+	 * @param ESteamLeaderboardDisplayType & LeaderboardDisplayType - The display type of the leaderboard.
+	 * @return bool - false if the leaderboard isn't cached.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|UserStats")
+	bool GetCachedLeaderboard(const FString& LeaderboardName, FSteamLeaderboard& SteamLeaderboard, ESteamLeaderboardSortMethod& LeaderboardSortMethod, ESteamLeaderboardDisplayType& LeaderboardDisplayType) const;
+
+	/**
+	 * Looks up every leaderboard listed in WarmUpLeaderboards (see USteamBridgeSettings) at once.
+	 * Call this once Steam is initialized, e.g. when the game instance starts.
+	 *
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	void WarmUpLeaderboards();
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	void ClearCache() { m_Cache.Empty(); }
+
+	/** Called when a lookup started by ResolveLeaderboard or WarmUpLeaderboards finished. */
+	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|UserStats", meta = (DisplayName = "OnLeaderboardResolved"))
+	FOnSteamLeaderboardResolvedDelegate m_OnLeaderboardResolved;
+
+protected:
+private:
+	struct FCachedLeaderboard
+	{
+		SteamLeaderboard_t Leaderboard;
+		ELeaderboardSortMethod SortMethod;
+		ELeaderboardDisplayType DisplayType;
+	};
+
+	// LeaderboardFindResult_t doesn't say which name was looked up, every lookup waits on its own call result
+	struct FLookup
+	{
+		USteamLeaderboardResolver* Owner;
+		FString Name;
+		CCallResult<FLookup, LeaderboardFindResult_t> CallResult;
+		TArray<TFunction<void(FSteamLeaderboard, bool)>> Callbacks;
+
+		// Set when a caller wants the leaderboard created, a plain lookup that was already pending is upgraded to FindOrCreateLeaderboard if it isn't found
+		bool bCreate;
+		bool bCreateIssued;
+		ELeaderboardSortMethod SortMethod;
+		ELeaderboardDisplayType DisplayType;
+
+		void OnFindResult(LeaderboardFindResult_t* pParam, bool bIOFailure) { Owner->HandleFindResult(*this, pParam, bIOFailure); }
+	};
+
+	FLookup* StartLookup(const FString& LeaderboardName, bool bCreate = false, ELeaderboardSortMethod SortMethod = k_ELeaderboardSortMethodNone, ELeaderboardDisplayType DisplayType = k_ELeaderboardDisplayTypeNone);
+	bool IssueLookup(FLookup& Lookup);
+	void HandleFindResult(FLookup& Lookup, LeaderboardFindResult_t* pParam, bool bIOFailure);
+	void FinishLookup(FLookup& Lookup, SteamLeaderboard_t Leaderboard, bool bFound);
+
+	TMap<FString, FCachedLeaderboard> m_Cache;
+	TMap<FString, TUniquePtr<FLookup>> m_Lookups;
+
+	// Finished lookups are freed later, their call result is still running when they finish
+	TArray<TUniquePtr<FLookup>> m_FinishedLookups;
+};
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "Async/Future.h"
 #include "CoreMinimal.h"
 #include "Steam.h"
 #include "SteamEnums.h"
@@ -19,6 +20,13 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnRemoteStoragePublishedFileUnsubs
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnRemoteStorageSubscribePublishedFileResultDelegate, ESteamResult, Result, FPublishedFileId, PublishedFileID);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnRemoteStorageUnsubscribePublishedFileResultDelegate, ESteamResult, Result, FPublishedFileId, PublishedFileID);
 
+/** The result of USteamRemoteStorage::ReadFileAsync. */
+struct FSteamCloudReadResult
+{
+	ESteamResult Result;
+	TArray<uint8> Data;  // Pooled, hand it back with ReleaseBuffer once it's deserialized
+};
+
 /**
  * Provides functions for reading, writing, and accessing files which can be stored remotely in the Steam Cloud.
  * https://partner.steamgames.com/doc/api/ISteamRemoteStorage
@@ -44,7 +52,7 @@ public:
 	 * @return bool - true if the file exists and has been successfully deleted; otherwise, false if the file did not exist.
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
-	bool FileDelete(const FString& FileName) const { return SteamRemoteStorage()->FileDelete(TCHAR_TO_UTF8(*FileName)); }
+	bool FileDelete(const FString& FileName);
 
 	/**
 	 * Checks whether the specified file exists.
@@ -67,7 +75,7 @@ public:
 	 * @return bool - true if the file exists and has been successfully forgotten; otherwise, false.
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
-	bool FileForget(const FString& FileName) const { return SteamRemoteStorage()->FileForget(TCHAR_TO_UTF8(*FileName)); }
+	bool FileForget(const FString& FileName);
 
 	/**
 	 * Checks if a specific file is persisted in the steam cloud.
@@ -89,10 +97,39 @@ public:
 	 * @return int32 - The number of bytes read. Returns 0 if the file doesn't exist or the read fails.
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
-	int32 FileRead(const FString& FileName, TArray<uint8>& Data, int32 DataToRead) const;
+	int32 FileRead(const FString& FileName, TArray<uint8>& Data, int32 DataToRead);
+
+	/**
+	 * Starts an asynchronous read from a file.
+	 * The offset and amount to read should be valid for the size of the file, as indicated by GetFileSize or GetFileTimestamp.
+	 *
+	 * @param const FString & FileName - The name of the file to read from.
+	 * @param int32 Offset - The offset in bytes into the file where the read will start from. 0 if you're reading the whole file in one chunk.
+	 * @param int32 DataToRead - The amount of bytes to read starting from nOffset.
+	 * @return FSteamAPICall - SteamAPICall_t to be used with a RemoteStorageFileReadAsyncComplete_t call result. Returns k_uAPICallInvalid if the file doesn't exist or the offset and size are invalid.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
+	FSteamAPICall FileReadAsync(const FString& FileName, int32 Offset, int32 DataToRead) const { return SteamRemoteStorage()->FileReadAsync(TCHAR_TO_UTF8(*FileName), Offset, DataToRead); }
 
-	// #TODO: FileReadAsync
-	// #TODO: FileReadAsyncComplete
+	/**
+	 * Copies the bytes from a file which was asynchronously read with FileReadAsync into a byte array.
+	 * This should only ever be called after OnRemoteStorageFileReadAsyncComplete reported a successful read for the call.
+	 *
+	 * @param FSteamAPICall ReadCall - The call result handle passed into RemoteStorageFileReadAsyncComplete_t.
+	 * @param TArray<uint8> & Data - The buffer that the data will be copied into.
+	 * @param int32 DataToRead - The amount of bytes to read. This should be the BytesRead of OnRemoteStorageFileReadAsyncComplete.
+	 * @return bool - true if the data was copied.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
+	bool FileReadAsyncComplete(FSteamAPICall ReadCall, TArray<uint8>& Data, int32 DataToRead) const;
+
+	/**
+	 * Reads a whole file without blocking. The read is routed back to this request when RemoteStorageFileReadAsyncComplete_t arrives and copied into a pooled buffer.
+	 *
+	 * @param const FString & FileName - The name of the file to read.
+	 * @return TFuture<FSteamCloudReadResult> - Set on the game thread once the read finished.
+	 */
+	TFuture<FSteamCloudReadResult> ReadFileAsync(const FString& FileName);
 
 	/**
 	 * SteamAPICall_t to be used with a RemoteStorageFileShareResult_t call result.
@@ -120,9 +157,76 @@ public:
 	 * Steam could not write to the disk, the location might be read-only.
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
-	bool FileWrite(const FString& FileName, const TArray<uint8>& Data) const { return SteamRemoteStorage()->FileWrite(TCHAR_TO_UTF8(*FileName), Data.GetData(), Data.Num()); }
+	bool FileWrite(const FString& FileName, const TArray<uint8>& Data);
 
-	// #TODO: FileWriteAsync
+	/**
+	 * Creates a new file and asynchronously writes the raw byte data to the Steam Cloud, and then closes the file. If the target file already exists, it is overwritten.
+	 *
+	 * @param const FString & FileName - The name of the file to write to.
+	 * @param const TArray<uint8> & Data - The bytes to write to the file.
+	 * @return FSteamAPICall - SteamAPICall_t to be used with a RemoteStorageFileWriteAsyncComplete_t call result. Returns k_uAPICallInvalid under the same conditions FileWrite fails.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
+	FSteamAPICall FileWriteAsync(const FString& FileName, const TArray<uint8>& Data);
+
+	/**
+	 * Writes a whole file without blocking. The buffer is kept alive until the write finished and then goes back to the pool.
+	 *
+	 * @param const FString & FileName - The name of the file to write to.
+	 * @param TArray<uint8> && Data - The bytes to write, ideally serialized into a buffer from AcquireBuffer.
+	 * @return TFuture<ESteamResult> - Set on the game thread once the write finished.
+	 */
+	TFuture<ESteamResult> WriteFileAsync(const FString& FileName, TArray<uint8>&& Data);
+
+	/** Gets an empty buffer from the pool used by ReadFileAsync and WriteFileAsync. */
+	TArray<uint8> AcquireBuffer();
+
+	/** Returns a buffer to the pool, e.g. the data of a FSteamCloudReadResult once it was deserialized. */
+	void ReleaseBuffer(TArray<uint8>&& Buffer);
+
+	/**
+	 * Gets every file of the current user from the manifest cache. The manifest is built from GetFileCount/GetFileNameAndSize the first time it's needed
+	 * and then kept up to date by the writes, deletes and forgets made through this class, so listing files doesn't call into Steam again.
+	 *
+	 * @param TArray<FSteamCloudFile> & Files - The cached files, in no particular order.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
+	void GetCloudFiles(TArray<FSteamCloudFile>& Files);
+
+	/**
+	 * Gets a single file from the manifest cache.
+	 *
+	 * @param const FString & FileName - The name of the file.
+	 * @param FSteamCloudFile & File - The cached file.
+	 * @return bool - false if the file doesn't exist.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
+	bool GetCloudFile(const FString& FileName, FSteamCloudFile& File);
+
+	/** Rebuilds the manifest the next time it's used, e.g. after files were written without going through this class. */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|RemoteStorage")
+	void InvalidateManifest() { m_bManifestValid = false; }
+
+	/**
+	 * Marks a file as critical so it's never forgotten to make space. Files matching CloudCriticalFiles (see USteamBridgeSettings) are always critical.
+	 *
+	 * @param const FString & FileName - The name of the file.
+	 * @param bool bCritical - Whether the file is critical.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|RemoteStorage")
+	void SetFileCritical(const FString& FileName, bool bCritical);
+
+	/**
+	 * Makes sure a write of Bytes fits in the quota with CloudReserveBytes to spare, forgetting the least recently used non-critical files if it doesn't.
+	 * FileWrite, FileWriteAsync and WriteFileAsync do this on their own. Forgotten files stay on the local disk.
+	 *
+	 * @param int64 Bytes - The size of the write.
+	 * @return bool - false if not enough space could be freed.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
+	bool EnsureCloudSpace(int64 Bytes) { return MakeCloudSpace(Bytes, FString()); }
 
 	/**
 	 * Cancels a file write stream that was started by FileWriteStreamOpen. This trashes all of the data written and closes the write stream, but if there was an existing file with this name, it remains untouched.
@@ -131,7 +235,7 @@ public:
 	 * @return bool
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
-	bool FileWriteStreamCancel(FUGCFileWriteStreamHandle WriteHandle) const { return SteamRemoteStorage()->FileWriteStreamCancel(WriteHandle); }
+	bool FileWriteStreamCancel(FUGCFileWriteStreamHandle WriteHandle);
 
 	/**
 	 * Closes a file write stream that was started by FileWriteStreamOpen. This flushes the stream to the disk, overwriting the existing file if there was one.
@@ -140,7 +244,7 @@ public:
 	 * @return bool - true if the file write stream was successfully closed, the file has been committed to the disk. false if writeHandle is not a valid file write stream.
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
-	bool FileWriteStreamClose(FUGCFileWriteStreamHandle WriteHandle) const { return SteamRemoteStorage()->FileWriteStreamClose(WriteHandle); }
+	bool FileWriteStreamClose(FUGCFileWriteStreamHandle WriteHandle);
 
 	/**
 	 * Creates a new file output stream allowing you to stream out data to the Steam Cloud file in chunks. If the target file already exists, it is not overwritten until FileWriteStreamClose has been called.
@@ -152,7 +256,7 @@ public:
 	 * The current user's Steam Cloud storage quota has been exceeded. They may have run out of space, or have too many files.
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
-	FUGCFileWriteStreamHandle FileWriteStreamOpen(const FString& FileName) const { return SteamRemoteStorage()->FileWriteStreamOpen(TCHAR_TO_UTF8(*FileName)); }
+	FUGCFileWriteStreamHandle FileWriteStreamOpen(const FString& FileName);
 
 	/**
 	 * Writes a blob of data to the file write stream.
@@ -227,8 +331,18 @@ public:
 	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|RemoteStorage")
 	ESteamRemoteStoragePlatform GetSyncPlatforms(const FString& FileName) const { return (ESteamRemoteStoragePlatform)SteamRemoteStorage()->GetSyncPlatforms(TCHAR_TO_UTF8(*FileName)); }
 
-	// #NOTE: No docs for this method currently
-	// #TODO: GetUGCDetails
+	/**
+	 * Gets the details of a piece of UGC that finished downloading with UGCDownload.
+	 *
+	 * @param FUGCHandle ContentHandle - The UGC handle.
+	 * @param int32 & AppID - The app the content belongs to.
+	 * @param FString & FileName - The name of the file.
+	 * @param int32 & FileSizeInBytes - The size of the file in bytes.
+	 * @param FSteamID & SteamIDOwner - The user who shared the file.
+	 * @return bool - false if the content isn't downloaded.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
+	bool GetUGCDetails(FUGCHandle ContentHandle, int32& AppID, FString& FileName, int32& FileSizeInBytes, FSteamID& SteamIDOwner) const;
 
 	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|RemoteStorage")
 	bool GetUGCDownloadProgress(FUGCHandle ContentHandle, int32& BytesDownloaded, int32& BytesExpected) const { return SteamRemoteStorage()->GetUGCDownloadProgress(ContentHandle, &BytesDownloaded, &BytesExpected); }
@@ -295,8 +409,18 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
 	FSteamAPICall UGCDownloadToLocation(FUGCHandle ContentHandle, const FString& Location, int32 Priority) const { return SteamRemoteStorage()->UGCDownloadToLocation(ContentHandle, TCHAR_TO_UTF8(*Location), Priority); }
 
-	// #NOTE: No docs for this method currently
-	// #TODO: UGCRead
+	/**
+	 * Reads part of a piece of UGC that finished downloading with UGCDownload.
+	 *
+	 * @param FUGCHandle ContentHandle - The UGC handle.
+	 * @param TArray<uint8> & Data - The buffer the bytes are read into.
+	 * @param int32 DataToRead - The number of bytes to read.
+	 * @param int32 Offset - The offset in bytes into the file to start reading from.
+	 * @param ESteamUGCReadAction Action - Whether the file is kept open for further reads. ContinueReadingUntilFinished closes it once the last byte was read.
+	 * @return int32 - The number of bytes read, 0 if the content isn't downloaded.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
+	int32 UGCRead(FUGCHandle ContentHandle, TArray<uint8>& Data, int32 DataToRead, int32 Offset, ESteamUGCReadAction Action) const;
 
 	/** Delegates */
 
@@ -330,6 +454,48 @@ public:
 
 protected:
 private:
+	// RemoteStorageFileWriteAsyncComplete_t doesn't say which write finished, every write waits on its own call result
+	struct FPendingWrite
+	{
+		USteamRemoteStorage* Owner;
+		TPromise<ESteamResult> Promise;
+		FString FileName;
+		TArray<uint8> Data;
+		CCallResult<FPendingWrite, RemoteStorageFileWriteAsyncComplete_t> CallResult;
+
+		void OnWriteComplete(RemoteStorageFileWriteAsyncComplete_t* pParam, bool bIOFailure) { Owner->HandleWriteComplete(*this, pParam, bIOFailure); }
+	};
+
+	void HandleWriteComplete(FPendingWrite& Write, RemoteStorageFileWriteAsyncComplete_t* pParam, bool bIOFailure);
+
+	struct FCloudFile
+	{
+		int32 Size;
+		int64 Timestamp;
+		int64 LastUsed;  // Unix time the file was last read or written, its timestamp until then
+		bool bPersisted;
+	};
+
+	void BuildManifest();
+	void RefreshManifestEntry(const FString& FileName);
+	void TouchManifestEntry(const FString& FileName);
+	bool IsFileCritical(const FString& FileName) const;
+	bool MakeCloudSpace(int64 Bytes, const FString& WritingFileName);
+
+	TMap<SteamAPICall_t, TPromise<FSteamCloudReadResult>> m_PendingReads;
+	TArray<TUniquePtr<FPendingWrite>> m_PendingWrites;
+
+	// Finished writes are freed later, their call result is still running when they finish
+	TArray<TUniquePtr<FPendingWrite>> m_FinishedWrites;
+
+	TArray<TArray<uint8>> m_BufferPool;
+
+	TMap<FString, FCloudFile> m_Manifest;
+	TSet<FString> m_CriticalFiles;
+	TMap<UGCFileWriteStreamHandle_t, FString> m_OpenWriteStreams;
+	int32 m_NumUntrackedWrites;  // FileWriteAsync calls in flight, their completion doesn't say which file was written
+	bool m_bManifestValid;
+
 	STEAM_CALLBACK_MANUAL(USteamRemoteStorage, OnRemoteStorageDownloadUGCResult, RemoteStorageDownloadUGCResult_t, OnRemoteStorageDownloadUGCResultCallback);
 	STEAM_CALLBACK_MANUAL(USteamRemoteStorage, OnRemoteStorageFileReadAsyncComplete, RemoteStorageFileReadAsyncComplete_t, OnRemoteStorageFileReadAsyncCompleteCallback);
 	STEAM_CALLBACK_MANUAL(USteamRemoteStorage, OnRemoteStorageFileShareResult, RemoteStorageFileShareResult_t, OnRemoteStorageFileShareResultCallback);
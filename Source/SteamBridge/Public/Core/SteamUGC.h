@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Steam.h"
 #include "SteamEnums.h"
+#include "SteamBridgeUtils.h"
 #include "SteamStructs.h"
 #include "UObject/NoExportTypes.h"
 
@@ -295,7 +296,7 @@ public:
 	 * @param FPublishedFileId PublishedFileID - The workshop item to get the install info for.
 	 * @param int64 & SizeOnDisk - Returns the size of the workshop item in bytes.
 	 * @param FString & FolderName - Returns the absolute path to the folder containing the content by copying it.
-	 * @param int32 FolderSize - The size of pchFolder in bytes.
+	 * @param int32 FolderSize - The size of pchFolder in bytes. Pass 0 to use the default limit.
 	 * @param int32 & TimeStamp - Returns the time when the workshop item was last updated.
 	 * @return bool - true if the workshop item is already installed. false in the following cases:
 	 * cchFolderSize is 0.
@@ -323,7 +324,7 @@ public:
 	 * @return ESteamItemUpdateStatus - The current status.
 	 */
 	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
-	ESteamItemUpdateStatus GetItemUpdateProgress(FUGCUpdateHandle handle, int64& BytesProcessed, int64& BytesTotal) const { return (ESteamItemUpdateStatus)SteamUGC()->GetItemUpdateProgress(handle, (uint64*)BytesProcessed, (uint64*)BytesTotal); }
+	ESteamItemUpdateStatus GetItemUpdateProgress(FUGCUpdateHandle handle, int64& BytesProcessed, int64& BytesTotal) const { return (ESteamItemUpdateStatus)SteamUGC()->GetItemUpdateProgress(handle, (uint64*)&BytesProcessed, (uint64*)&BytesTotal); }
 
 	/**
 	 * Gets the total number of items the current user is subscribed to for the game or application.
@@ -343,9 +344,9 @@ public:
 	 * @param int32 index - The index of the item to get the details of.
 	 * @param int32 previewIndex - The index of the additional preview to get the details of.
 	 * @param FString & URLOrVideoID - Returns a URL or Video ID by copying it into this string.
-	 * @param int32 URLSize - The size of pchURLOrVideoID in bytes.
+	 * @param int32 URLSize - The size of pchURLOrVideoID in bytes. Pass 0 to use k_cchPublishedFileURLMax.
 	 * @param FString & OriginalFileName - Returns the original file name. May be set to NULL to not receive this.
-	 * @param int32 OriginalFileNameSize - The size of pchOriginalFileName in bytes.
+	 * @param int32 OriginalFileNameSize - The size of pchOriginalFileName in bytes. Pass 0 to use k_cchFilenameMax.
 	 * @param ESteamItemPreviewType & PreviewType - The type of preview that was returned.
 	 * @return bool - true upon success, indicates that pchURLOrVideoID and pPreviewType have been filled out. Otherwise, false if the UGC query handle is invalid, the index is out of bounds, or previewIndex is out of bounds.
 	 */
@@ -361,7 +362,7 @@ public:
 	 * @param FUGCQueryHandle handle - The UGC query handle to get the results from.
 	 * @param int32 index - The index of the item to get the details of.
 	 * @param TArray<FPublishedFileId> & PublishedFileIDs - Returns the UGC children by setting this array.
-	 * @param int32 MaxEntries - The length of pvecPublishedFileID.
+	 * @param int32 MaxEntries - The maximum number of IDs to return, capped to m_unNumChildren from the query result. Pass 0 to return all of them.
 	 * @return bool - true upon success, indicates that pvecPublishedFileID has been filled out. Otherwise, false if the UGC query handle is invalid or the index is out of bounds.
 	 */
 	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
@@ -381,9 +382,9 @@ public:
 	 * @param int32 index - The index of the item to get the details of.
 	 * @param int32 keyValueTagIndex - The index of the tag to get the details of.
 	 * @param FString & Key - 	Returns the key by copying it into this string.
-	 * @param int32 KeySize - The size of pchKey in bytes.
+	 * @param int32 KeySize - The size of pchKey in bytes. Pass 0 to use the 255 character limit.
 	 * @param FString & Value - Returns the value by copying it into this string.
-	 * @param int32 ValueSize - The size of pchValue in bytes.
+	 * @param int32 ValueSize - The size of pchValue in bytes. Pass 0 to use the 255 character limit.
 	 * @return bool - true upon success, indicates that pchKey and pchValue have been filled out. Otherwise, false if the UGC query handle is invalid, the index is out of bounds, or keyValueTagIndex is out of bounds.
 	 */
 	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
@@ -397,7 +398,7 @@ public:
 	 * @param FUGCQueryHandle handle - The UGC query handle to get the results from.
 	 * @param int32 index - The index of the item to get the details of.
 	 * @param FString & Metadata - Returns the url by copying it into this string.
-	 * @param int32 Metadatasize - The size of pchMetadata in bytes.
+	 * @param int32 Metadatasize - The size of pchMetadata in bytes. Pass 0 to use k_cchDeveloperMetadataMax.
 	 * @return bool - true upon success, indicates that pchMetadata has been filled out. Otherwise, false if the UGC query handle is invalid or the index is out of bounds.
 	 */
 	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
@@ -438,7 +439,7 @@ public:
 	 * @param FUGCQueryHandle handle - The UGC query handle to get the results from.
 	 * @param int32 index - The index of the item to get the details of.
 	 * @param FString & URL - Returns the url by copying it into this string.
-	 * @param int32 URLSize - The size of pchURL in bytes.
+	 * @param int32 URLSize - The size of pchURL in bytes. Pass 0 to use k_cchPublishedFileURLMax.
 	 * @return bool - true upon success, indicates that pchURL has been filled out. Otherwise, false if the UGC query handle is invalid or the index is out of bounds.
 	 */
 	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
@@ -476,7 +477,7 @@ public:
 	 * You create an array with the size provided by GetNumSubscribedItems before calling this.
 	 *
 	 * @param TArray<FPublishedFileId> & PublishedFileIDs - The array where the item ids will be copied into.
-	 * @param int32 MaxEntries - The maximum number of items to return. This should typically be the same as GetNumSubscribedItems and the same size as pvecPublishedFileID.
+	 * @param int32 MaxEntries - The maximum number of items to return. This should typically be the same as GetNumSubscribedItems. Pass 0 to use GetNumSubscribedItems.
 	 * @return int32 - The number of subscribed workshop items that were populated into pvecPublishedFileID. Returns 0 if called from a game server.
 	 */
 	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
@@ -979,6 +980,9 @@ public:
 
 protected:
 private:
+	/** Reused by the string getters so they don't allocate a temporary buffer per call. */
+	mutable FSteamScratchBuffer m_ScratchBuffer;
+
 	STEAM_CALLBACK_MANUAL(USteamUGC, OnAddAppDependencyResult, AddAppDependencyResult_t, OnAddAppDependencyResultCallback);
 	STEAM_CALLBACK_MANUAL(USteamUGC, OnAddUGCDependencyResult, AddUGCDependencyResult_t, OnAddUGCDependencyResultCallback);
 	STEAM_CALLBACK_MANUAL(USteamUGC, OnCreateItemResult, CreateItemResult_t, OnCreateItemResultCallback);
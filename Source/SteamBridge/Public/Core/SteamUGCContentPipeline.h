@@ -0,0 +1,93 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Queue.h"
+#include "CoreMinimal.h"
+#include "Steam.h"
+#include "SteamEnums.h"
+#include "SteamStructs.h"
+#include "UObject/NoExportTypes.h"
+
+#include "SteamUGCContentPipeline.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnUGCContentMountedDelegate, const TArray<FSteamUGCContentScanResult>&, Results);
+
+/**
+ * Scans, hashes and validates the content of installed workshop items on the task graph and mounts their paks.
+ * Scans run with bounded parallelism and every scan that finished during a frame is mounted in one batch on the game thread.
+ */
+UCLASS()
+class STEAMBRIDGE_API USteamUGCContentPipeline final : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	USteamUGCContentPipeline();
+	~USteamUGCContentPipeline();
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore", meta = (DisplayName = "Steam UGC Content Pipeline", CompactNodeTitle = "SteamUGCContentPipeline"))
+	static USteamUGCContentPipeline* GetSteamUGCContentPipeline() { return USteamUGCContentPipeline::StaticClass()->GetDefaultObject<USteamUGCContentPipeline>(); }
+
+	/**
+	 * Starts processing items as soon as OnItemInstalled fires for them.
+	 *
+	 * @param int32 MaxParallelScans - The maximum number of items that are scanned at once.
+	 * @param int32 PakMountOrder - The order passed to the pak mounter for every mounted pak.
+	 * @param bool bProcessInstalledItems - Also queue every subscribed item that's already installed.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UGC")
+	void StartPipeline(int32 MaxParallelScans = 4, int32 PakMountOrder = 4, bool bProcessInstalledItems = true);
+
+	/**
+	 * Stops reacting to OnItemInstalled and drops the queued items. Scans that are already running finish but aren't mounted.
+	 *
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UGC")
+	void StopPipeline();
+
+	/**
+	 * Queues an installed item to be scanned and mounted. Items that aren't installed are ignored.
+	 *
+	 * @param FPublishedFileId PublishedFileID - The workshop item.
+	 * @return bool - true if the item was queued.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UGC")
+	bool QueueItem(FPublishedFileId PublishedFileID);
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
+	int32 GetNumPendingItems() const { return m_PendingItems.Num() + m_NumScansInFlight.GetValue(); }
+
+	/** Called once per frame with every item that finished scanning and mounting during that frame. */
+	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|UGC", meta = (DisplayName = "OnContentMounted"))
+	FOnUGCContentMountedDelegate m_OnContentMounted;
+
+protected:
+private:
+	bool Tick(float DeltaTime);
+	void LaunchScans();
+	void MountCompletedScans();
+
+	static void ScanContent(FSteamUGCContentScanResult& Result);
+	static bool IsValidPakFile(const FString& FileName);
+
+	UFUNCTION()
+	void HandleItemInstalled(int32 AppID, FPublishedFileId PublishedFileID);
+
+	TArray<FSteamUGCContentScanResult> m_PendingItems;
+	TSet<uint64> m_QueuedItems;
+
+	// Completed scans tagged with the generation they were launched in so scans from a stopped run are dropped
+	TQueue<TPair<uint32, FSteamUGCContentScanResult>, EQueueMode::Mpsc> m_CompletedScans;
+	FThreadSafeCounter m_NumScansInFlight;
+	TArray<FSteamUGCContentScanResult> m_MountBatch;
+
+	int32 m_MaxParallelScans;
+	int32 m_PakMountOrder;
+	uint32 m_Generation;
+	bool m_bRunning;
+
+	FDelegateHandle m_TickHandle;
+};
@@ -0,0 +1,149 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "Async/Future.h"
+#include "CoreMinimal.h"
+#include "Core/SteamRemoteStorage.h"
+#include "Misc/Optional.h"
+#include "Steam.h"
+#include "SteamEnums.h"
+#include "SteamStructs.h"
+#include "UObject/NoExportTypes.h"
+
+#include "SteamUGCDownloader.generated.h"
+
+/** Receives the bytes of a UGC file in order as they're read. Return false to cancel the download. */
+using FSteamUGCSink = TFunction<bool(TArrayView<const uint8>)>;
+
+/**
+ * Downloads UGC files (e.g. replays attached to leaderboard entries) with UGCDownload and streams them out of the Steam cache with UGCRead,
+ * so they never have to be written to a location on disk first.
+ * Downloads are started from a priority queue. A new one only starts while fewer than MaxConcurrentDownloads are running and the bytes the
+ * running downloads still expect are below MaxBytesInFlight, so a few large files don't starve each other of bandwidth.
+ * Finished files are read in slices of ReadBytesPerTick per frame to keep UGCRead from hitching.
+ */
+UCLASS()
+class STEAMBRIDGE_API USteamUGCDownloader final : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	USteamUGCDownloader();
+	~USteamUGCDownloader();
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore", meta = (DisplayName = "Steam UGC Downloader", CompactNodeTitle = "SteamUGCDownloader"))
+	static USteamUGCDownloader* GetSteamUGCDownloader() { return USteamUGCDownloader::StaticClass()->GetDefaultObject<USteamUGCDownloader>(); }
+
+	/**
+	 * Downloads a UGC file into memory. The buffer is allocated once at the size of the file and read into directly.
+	 *
+	 * @param FUGCHandle ContentHandle - The UGC handle, e.g. FSteamLeaderboardEntry::UGC.
+	 * @param int32 Priority - Higher priorities are started first.
+	 * @return TFuture<FSteamCloudReadResult> - Set on the game thread once the file was read. Busy if the handle is already being downloaded.
+	 */
+	TFuture<FSteamCloudReadResult> DownloadToMemory(FUGCHandle ContentHandle, int32 Priority = 0);
+
+	/**
+	 * Downloads a UGC file and hands it to Sink in slices of at most ReadBytesPerTick, nothing is held in memory after a slice was consumed.
+	 *
+	 * @param FUGCHandle ContentHandle - The UGC handle.
+	 * @param FSteamUGCSink && Sink - Receives the file in order.
+	 * @param int32 Priority - Higher priorities are started first.
+	 * @return TFuture<ESteamResult> - Set on the game thread once the file was read. Cancelled if the sink returned false.
+	 */
+	TFuture<ESteamResult> DownloadToSink(FUGCHandle ContentHandle, FSteamUGCSink&& Sink, int32 Priority = 0);
+
+	/**
+	 * Cancels a queued or running download. Its future is set to Cancelled.
+	 *
+	 * @param FUGCHandle ContentHandle - The UGC handle.
+	 * @return bool - false if the handle isn't being downloaded.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
+	bool CancelDownload(FUGCHandle ContentHandle);
+
+	/**
+	 * Gets the progress of a download, first of UGCDownload and then of reading the file.
+	 *
+	 * @param FUGCHandle ContentHandle - The UGC handle.
+	 * @param int32 & BytesDone - The bytes downloaded, or read once the download finished.
+	 * @param int32 & BytesExpected - The size of the file, 0 until Steam knows it.
+	 * @param bool & bReading - Whether the download finished and the file is being read.
+	 * @return bool - false if the handle isn't being downloaded.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|RemoteStorage")
+	bool GetDownloadProgress(FUGCHandle ContentHandle, int32& BytesDone, int32& BytesExpected, bool& bReading) const;
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|RemoteStorage")
+	void SetMaxConcurrentDownloads(int32 MaxConcurrentDownloads) { m_MaxConcurrentDownloads = FMath::Max(1, MaxConcurrentDownloads); }
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|RemoteStorage")
+	void SetMaxBytesInFlight(int32 MaxBytesInFlight) { m_MaxBytesInFlight = FMath::Max(0, MaxBytesInFlight); }
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|RemoteStorage")
+	void SetReadBytesPerTick(int32 ReadBytesPerTick) { m_ReadBytesPerTick = FMath::Max(1024, ReadBytesPerTick); }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|RemoteStorage")
+	int32 GetNumQueuedDownloads() const { return m_DownloadQueue.Num(); }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|RemoteStorage")
+	int32 GetNumActiveDownloads() const { return m_Downloads.Num() - m_DownloadQueue.Num(); }
+
+protected:
+private:
+	enum class EDownloadState : uint8
+	{
+		Queued,
+		Downloading,
+		Reading
+	};
+
+	struct FDownload
+	{
+		EDownloadState State;
+		int32 Size;
+		int32 Offset;  // Bytes read with UGCRead so far
+
+		// Only the promise of the kind of download is constructed, an unset promise asserts when it's destroyed
+		bool bToMemory;
+		TArray<uint8> Data;
+		TOptional<TPromise<FSteamCloudReadResult>> MemoryPromise;
+		FSteamUGCSink Sink;
+		TOptional<TPromise<ESteamResult>> SinkPromise;
+
+		bool bCancelled;  // CancelDownload was called from the sink, finished once the sink returned
+	};
+
+	struct FQueuedDownload
+	{
+		UGCHandle_t Handle;
+		int32 Priority;
+		uint32 Sequence;
+
+		// TArray's heap functions keep the element that sorts first at the top
+		bool operator<(const FQueuedDownload& Other) const { return Priority != Other.Priority ? Priority > Other.Priority : Sequence < Other.Sequence; }
+	};
+
+	FDownload* AddDownload(UGCHandle_t Handle, int32 Priority);
+	void FinishDownload(UGCHandle_t Handle, ESteamResult Result);
+
+	bool Tick(float DeltaTime);
+	void PumpDownloadQueue();
+	bool ReadDownload(UGCHandle_t Handle, FDownload& Download, int32& ReadBudget, ESteamResult& Result);
+
+	UFUNCTION()
+	void HandleDownloadUGCResult(ESteamResult Result, FUGCHandle FileHandle, int32 AppID, int32 SizeInBytes, FString FileName, FSteamID SteamIDOwner);
+
+	TMap<UGCHandle_t, TUniquePtr<FDownload>> m_Downloads;
+	TArray<FQueuedDownload> m_DownloadQueue;
+	TArray<uint8> m_ReadBuffer;  // Slice handed to sinks, reused for every read
+	UGCHandle_t m_SinkHandle;  // The download whose sink is running, k_UGCHandleInvalid otherwise
+	uint32 m_NextSequence;
+
+	int32 m_MaxConcurrentDownloads;
+	int32 m_MaxBytesInFlight;
+	int32 m_ReadBytesPerTick;
+
+	FDelegateHandle m_TickHandle;
+};
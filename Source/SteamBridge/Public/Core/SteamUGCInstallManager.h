@@ -0,0 +1,166 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Steam.h"
+#include "SteamEnums.h"
+#include "SteamStructs.h"
+#include "UObject/NoExportTypes.h"
+
+#include "SteamUGCInstallManager.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnUGCInstallEntryChangedDelegate, const FSteamUGCInstallEntry&, Entry);
+
+/**
+ * Keeps a live table of every subscribed workshop item and drives their downloads.
+ * Downloads are started from a priority queue with a concurrency cap and their progress is polled once per frame in a single batch.
+ */
+UCLASS()
+class STEAMBRIDGE_API USteamUGCInstallManager final : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	USteamUGCInstallManager();
+	~USteamUGCInstallManager();
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore", meta = (DisplayName = "Steam UGC Install Manager", CompactNodeTitle = "SteamUGCInstallManager"))
+	static USteamUGCInstallManager* GetSteamUGCInstallManager() { return USteamUGCInstallManager::StaticClass()->GetDefaultObject<USteamUGCInstallManager>(); }
+
+	/**
+	 * Starts tracking the subscribed items. Builds the item table and queues every item that isn't installed or needs an update.
+	 *
+	 * @param int32 MaxConcurrentDownloads - The maximum number of DownloadItem calls that are in flight at once.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UGC")
+	void StartTracking(int32 MaxConcurrentDownloads = 4);
+
+	/**
+	 * Stops tracking and clears the item table. Downloads already started by Steam keep running.
+	 *
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UGC")
+	void StopTracking();
+
+	/**
+	 * Re-reads the subscribed items from Steam, adding new subscriptions and dropping removed ones.
+	 *
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UGC")
+	void RefreshSubscribedItems();
+
+	/**
+	 * Queues a download for an item, or bumps its priority if it's already queued.
+	 *
+	 * @param FPublishedFileId PublishedFileID - The workshop item to download.
+	 * @param int32 Priority - Higher priorities are started first. Items with the same priority are started in the order they were queued.
+	 * @param bool bHighPriority - Passed to DownloadItem, pauses other Steam downloads while this item downloads.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UGC")
+	void RequestDownload(FPublishedFileId PublishedFileID, int32 Priority = 0, bool bHighPriority = false);
+
+	/**
+	 * Tells the manager whether gameplay is running. While gameplay is active downloads are suspended with SuspendDownloads
+	 * (if SetSuspendDuringGameplay is enabled) and no new downloads are started.
+	 *
+	 * @param bool bActive - Whether gameplay is active.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UGC")
+	void SetGameplayActive(bool bActive);
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
+	bool IsGameplayActive() const { return m_bGameplayActive; }
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UGC")
+	void SetSuspendDuringGameplay(bool bSuspend);
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
+	bool GetSuspendDuringGameplay() const { return m_bSuspendDuringGameplay; }
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UGC")
+	void SetMaxConcurrentDownloads(int32 MaxConcurrentDownloads);
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
+	int32 GetMaxConcurrentDownloads() const { return m_MaxConcurrentDownloads; }
+
+	/**
+	 * Gets the tracked state of an item.
+	 *
+	 * @param FPublishedFileId PublishedFileID - The workshop item.
+	 * @param FSteamUGCInstallEntry & Entry - Returns the tracked state.
+	 * @return bool - true if the item is tracked.
+	 */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
+	bool GetInstallEntry(FPublishedFileId PublishedFileID, FSteamUGCInstallEntry& Entry) const;
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
+	void GetInstallEntries(TArray<FSteamUGCInstallEntry>& Entries) const { Entries = m_Entries; }
+
+	const TArray<FSteamUGCInstallEntry>& GetInstallEntryTable() const { return m_Entries; }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
+	int32 GetNumQueuedDownloads() const { return m_DownloadQueue.Num(); }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
+	int32 GetNumActiveDownloads() const { return m_ActiveDownloads.Num(); }
+
+	/** Called whenever the state, progress or install info of a tracked item changes. */
+	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|UGC", meta = (DisplayName = "OnInstallEntryChanged"))
+	FOnUGCInstallEntryChangedDelegate m_OnInstallEntryChanged;
+
+protected:
+private:
+	struct FQueuedDownload
+	{
+		uint64 PublishedFileID;
+		int32 Priority;
+		uint32 Sequence;
+		bool bHighPriority;
+
+		// TArray's heap functions keep the element that sorts first at the top
+		bool operator<(const FQueuedDownload& Other) const { return Priority != Other.Priority ? Priority > Other.Priority : Sequence < Other.Sequence; }
+	};
+
+	bool Tick(float DeltaTime);
+	void PollActiveDownloads();
+	void PumpDownloadQueue();
+	void ApplySuspendState();
+
+	FSteamUGCInstallEntry& FindOrAddEntry(uint64 PublishedFileID);
+	void RemoveEntry(uint64 PublishedFileID);
+	bool RefreshEntry(FSteamUGCInstallEntry& Entry);
+	void EnqueueIfNeeded(const FSteamUGCInstallEntry& Entry);
+
+	UFUNCTION()
+	void HandleItemInstalled(int32 AppID, FPublishedFileId PublishedFileID);
+
+	UFUNCTION()
+	void HandleDownloadItemResult(int32 AppID, FPublishedFileId PublishedFileID, ESteamResult Result);
+
+	UFUNCTION()
+	void HandlePublishedFileSubscribed(FPublishedFileId PublishedFileID, int32 AppID);
+
+	UFUNCTION()
+	void HandlePublishedFileUnsubscribed(FPublishedFileId PublishedFileID, int32 AppID);
+
+	TArray<FSteamUGCInstallEntry> m_Entries;
+	TMap<uint64, int32> m_EntryIndices;
+
+	TArray<FQueuedDownload> m_DownloadQueue;
+	TSet<uint64> m_ActiveDownloads;
+	uint32 m_NextSequence;
+
+	int32 m_MaxConcurrentDownloads;
+	bool m_bTracking;
+	bool m_bGameplayActive;
+	bool m_bSuspendDuringGameplay;
+	bool m_bDownloadsSuspended;
+
+	FDelegateHandle m_TickHandle;
+};
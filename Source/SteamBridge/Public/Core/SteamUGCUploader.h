@@ -0,0 +1,133 @@
+// Copyright 2020-2021 Russ 'trdwll' Treadwell <trdwll.com>. All Rights Reserved.
+
+#pragma once
+
+#include "Async/Future.h"
+#include "CoreMinimal.h"
+#include "Steam.h"
+#include "SteamEnums.h"
+#include "SteamStructs.h"
+#include "UObject/NoExportTypes.h"
+
+#include "SteamUGCUploader.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnUGCUploadProgressDelegate, const FSteamUGCUploadProgress&, Progress);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnUGCUploadCompletedDelegate, FPublishedFileId, PublishedFileID, ESteamResult, Result, bool, bUserNeedsToAcceptWorkshopLegalAgreement, const FSteamUGCStagingStats&, StagingStats);
+
+/**
+ * Uploads a queue of workshop item updates back to back.
+ * Content is staged into the Saved directory with hard links (falling back to a copy) and files that are already staged are skipped, so an interrupted staging resumes where it stopped.
+ * The next item is staged on the task graph while the current one uploads, and upload progress is polled on a timer.
+ */
+UCLASS()
+class STEAMBRIDGE_API USteamUGCUploader final : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	USteamUGCUploader();
+	~USteamUGCUploader();
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore", meta = (DisplayName = "Steam UGC Uploader", CompactNodeTitle = "SteamUGCUploader"))
+	static USteamUGCUploader* GetSteamUGCUploader() { return USteamUGCUploader::StaticClass()->GetDefaultObject<USteamUGCUploader>(); }
+
+	/**
+	 * Queues an update for an existing workshop item. Create the item with CreateItem first.
+	 *
+	 * @param const FSteamUGCItemUpload & Upload - The item, content and change note to upload.
+	 * @return bool - true if the update was queued. false if an update for this item is already queued.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UGC")
+	bool QueueUpload(const FSteamUGCItemUpload& Upload);
+
+	/**
+	 * Removes a queued update. The update that is currently being submitted can't be cancelled.
+	 *
+	 * @param FPublishedFileId PublishedFileID - The workshop item.
+	 * @return bool - true if the update was removed from the queue.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UGC")
+	bool CancelUpload(FPublishedFileId PublishedFileID);
+
+	/**
+	 * Sets how often GetItemUpdateProgress is polled while an update is being submitted.
+	 *
+	 * @param float Seconds - The poll interval.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UGC")
+	void SetProgressPollInterval(float Seconds);
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
+	float GetProgressPollInterval() const { return m_ProgressPollInterval; }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
+	int32 GetNumQueuedUploads() const { return m_Jobs.Num(); }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
+	bool IsUploading() const { return m_bSubmitting; }
+
+	/**
+	 * Gets the last polled progress of the update that is currently being submitted.
+	 *
+	 * @param FSteamUGCUploadProgress & Progress - Returns the progress.
+	 * @return bool - true if an update is being submitted.
+	 */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
+	bool GetCurrentProgress(FSteamUGCUploadProgress& Progress) const;
+
+	/**
+	 * Gets the average upload throughput over every update submitted so far.
+	 *
+	 * @return float - Bytes per second, 0 if nothing was uploaded yet.
+	 */
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
+	float GetAverageThroughput() const { return m_TotalUploadSeconds > 0.0 ? (float)(m_TotalBytesUploaded / m_TotalUploadSeconds) : 0.0f; }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UGC")
+	int64 GetTotalBytesUploaded() const { return m_TotalBytesUploaded; }
+
+	/** Called every poll interval while an update is being submitted. */
+	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|UGC", meta = (DisplayName = "OnUploadProgress"))
+	FOnUGCUploadProgressDelegate m_OnUploadProgress;
+
+	/** Called when an update finished submitting or failed to stage. */
+	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|UGC", meta = (DisplayName = "OnUploadCompleted"))
+	FOnUGCUploadCompletedDelegate m_OnUploadCompleted;
+
+protected:
+private:
+	struct FUploadJob
+	{
+		FSteamUGCItemUpload Upload;
+		FString StagingFolder;
+		TFuture<FSteamUGCStagingStats> Staging;
+	};
+
+	bool Tick(float DeltaTime);
+	void PollProgress();
+	void LaunchStaging();
+	bool TrySubmitNext();
+	void CompleteCurrentJob(ESteamResult Result, bool bUserNeedsToAcceptWorkshopLegalAgreement);
+
+	static FSteamUGCStagingStats StageContent(const FString& SourceFolder, const FString& StagingFolder);
+	static bool LinkStagedFile(const FString& Source, const FString& Dest);
+
+	void OnSubmitItemUpdateResult(SubmitItemUpdateResult_t* pParam, bool bIOFailure);
+
+	// m_Jobs[0] is the update being submitted (or the next one to submit), jobs are submitted in order
+	TArray<FUploadJob> m_Jobs;
+
+	FUGCUpdateHandle m_UpdateHandle;
+	CCallResult<USteamUGCUploader, SubmitItemUpdateResult_t> m_SubmitCallResult;  // Submits the game makes itself don't complete the current job
+	FSteamUGCUploadProgress m_Progress;
+	double m_SubmitStartTime;
+	double m_LastPollTime;
+	bool m_bSubmitting;
+
+	int64 m_TotalBytesUploaded;
+	double m_TotalUploadSeconds;
+
+	float m_ProgressPollInterval;
+	FDelegateHandle m_TickHandle;
+};
@@ -239,7 +239,7 @@ public:
 	 * The type matches the type listed in the App Admin panel of the Steamworks website.
 	 */
 	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UserStats")
-	bool GetGlobalStatFloat(const FString& StatName, float& Data) const { return SteamUserStats()->GetGlobalStat(TCHAR_TO_UTF8(*StatName), (double*)&Data); }
+	bool GetGlobalStatFloat(const FString& StatName, float& Data) const;
 
 	/**
 	 * Gets the daily history for an aggregated stat. pData will be filled with daily values, starting with today. So when called, pData[0] will be today, pData[1] will be yesterday, and pData[2] will be two days ago, etc.
@@ -247,7 +247,7 @@ public:
 	 *
 	 * @param const FString & StatName - The 'API Name' of the stat. Must not be longer than k_cchStatNameMax.
 	 * @param TArray<int64> & Data - Array that the daily history will be returned into.
-	 * @param int32 Size - The total size in bytes of the pData array.
+	 * @param int32 Size - The maximum number of days to return.
 	 * @return int32 - The number of elements returned in the pData array.
 	 * A value of 0 indicates failure for one of the following reasons:
 	 * The specified stat does not exist in App Admin on the Steamworks website, or the changes aren't published.
@@ -256,7 +256,7 @@ public:
 	 * There is no history available.
 	 */
 	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UserStats")
-	int32 GetGlobalStatHistoryInt64(const FString& StatName, TArray<int64>& Data, int32 Size = 10) const { return SteamUserStats()->GetGlobalStatHistory(TCHAR_TO_UTF8(*StatName), Data.GetData(), Size); }
+	int32 GetGlobalStatHistoryInt64(const FString& StatName, TArray<int64>& Data, int32 Size = 10) const;
 
 	/**
 	 * Gets the daily history for an aggregated stat. pData will be filled with daily values, starting with today. So when called, pData[0] will be today, pData[1] will be yesterday, and pData[2] will be two days ago, etc.
@@ -264,7 +264,7 @@ public:
 	 *
 	 * @param const FString & StatName - The 'API Name' of the stat. Must not be longer than k_cchStatNameMax.
 	 * @param TArray<float> & Data - Array that the daily history will be returned into.
-	 * @param int32 Size - The total size in bytes of the pData array.
+	 * @param int32 Size - The maximum number of days to return.
 	 * @return int32 - The number of elements returned in the pData array.
 	 * A value of 0 indicates failure for one of the following reasons:
 	 * The specified stat does not exist in App Admin on the Steamworks website, or the changes aren't published.
@@ -339,6 +339,19 @@ public:
 	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UserStats")
 	int32 GetNextMostAchievedAchievementInfo(int32 IteratorPrevious, FString& Name, float& Percent, bool& bAchieved) const;
 
+	/**
+	 * Gets the global unlock percentage of every achievement, most achieved first.
+	 * The percentages are read once when OnGlobalAchievementPercentagesReady is called after RequestGlobalAchievementPercentages, this only copies them.
+	 *
+	 * @param TArray<FSteamAchievementPercentage> & Percentages - Empty until the percentages were received.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|UserStats")
+	void GetAllAchievementPercentages(TArray<FSteamAchievementPercentage>& Percentages) const { Percentages = m_AchievementPercentages; }
+
+	/** Same as above without copying. */
+	const TArray<FSteamAchievementPercentage>& GetAllAchievementPercentages() const { return m_AchievementPercentages; }
+
 	/**
 	 * Get the number of achievements defined in the App Admin panel of the Steamworks website.
 	 * This is used for iterating through all of the achievements with GetAchievementName.
@@ -626,6 +639,119 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|UserStats")
 	FSteamAPICall UploadLeaderboardScore(FSteamLeaderboard SteamLeaderboard, ESteamLeaderboardUploadScoreMethod LeaderboardUploadScoreMethod, int32 Score, const TArray<int32>& ScoreDetails) const;
 
+	/** Stat handles */
+
+	/**
+	 * Returns the handle of a stat or achievement, building it the first time a name is used.
+	 * Handles of every achievement in the schema are built up front once the current user's stats were received.
+	 * The overloads below take handles instead of names so the name isn't converted to UTF-8 on every call. They're C++ only, Blueprint uses the stat slots below.
+	 *
+	 * @param const FString & Name - The 'API Name' of the stat or achievement.
+	 * @return FSteamStatHandle - The handle, keep it around instead of calling this every time.
+	 */
+	FSteamStatHandle MakeStatHandle(const FString& Name);
+
+	/**
+	 * Gets the handles of every achievement of the current app.
+	 *
+	 * @param TArray<FSteamStatHandle> & Handles - Empty until the current user's stats were received.
+	 * @return void
+	 */
+	void GetAchievementHandles(TArray<FSteamStatHandle>& Handles) const { Handles = m_AchievementHandles; }
+
+	bool ClearAchievement(const FSteamStatHandle& Handle) const { return SteamUserStats()->ClearAchievement(Handle.Get()); }
+	bool GetAchievement(const FSteamStatHandle& Handle, bool& bAchieved) const { return SteamUserStats()->GetAchievement(Handle.Get(), &bAchieved); }
+	bool GetAchievementAchievedPercent(const FSteamStatHandle& Handle, float& Percent) const { return SteamUserStats()->GetAchievementAchievedPercent(Handle.Get(), &Percent); }
+	bool GetAchievementAndUnlockTime(const FSteamStatHandle& Handle, bool& bAchieved, int32& UnlockTime) const { return SteamUserStats()->GetAchievementAndUnlockTime(Handle.Get(), &bAchieved, (uint32*)&UnlockTime); }
+	FString GetAchievementDisplayAttribute(const FSteamStatHandle& Handle, const FString& Key) const { return SteamUserStats()->GetAchievementDisplayAttribute(Handle.Get(), TCHAR_TO_UTF8(*Key)); }
+	int32 GetAchievementIcon(const FSteamStatHandle& Handle) const { return SteamUserStats()->GetAchievementIcon(Handle.Get()); }
+	bool GetGlobalStatInt64(const FSteamStatHandle& Handle, int64& Data) const { return SteamUserStats()->GetGlobalStat(Handle.Get(), &Data); }
+	bool GetGlobalStatFloat(const FSteamStatHandle& Handle, float& Data) const;
+	bool GetStatInt32(const FSteamStatHandle& Handle, int32& Data) const { return SteamUserStats()->GetStat(Handle.Get(), &Data); }
+	bool GetStatFloat(const FSteamStatHandle& Handle, float& Data) const { return SteamUserStats()->GetStat(Handle.Get(), &Data); }
+	bool GetUserAchievement(FSteamID SteamIDUser, const FSteamStatHandle& Handle, bool& bAchieved) const { return SteamUserStats()->GetUserAchievement(SteamIDUser, Handle.Get(), &bAchieved); }
+	bool GetUserAchievementAndUnlockTime(FSteamID SteamIDUser, const FSteamStatHandle& Handle, bool& bAchieved, int32& UnlockTime) const { return SteamUserStats()->GetUserAchievementAndUnlockTime(SteamIDUser, Handle.Get(), &bAchieved, (uint32*)&UnlockTime); }
+	bool GetUserStatInt32(FSteamID SteamIDUser, const FSteamStatHandle& Handle, int32& Data) const { return SteamUserStats()->GetUserStat(SteamIDUser, Handle.Get(), &Data); }
+	bool GetUserStatFloat(FSteamID SteamIDUser, const FSteamStatHandle& Handle, float& Data) const { return SteamUserStats()->GetUserStat(SteamIDUser, Handle.Get(), &Data); }
+	bool IndicateAchievementProgress(const FSteamStatHandle& Handle, int32 CurProgress, int32 MaxProgress) const { return SteamUserStats()->IndicateAchievementProgress(Handle.Get(), CurProgress, MaxProgress); }
+	bool SetAchievement(const FSteamStatHandle& Handle) const { return SteamUserStats()->SetAchievement(Handle.Get()); }
+	bool SetStatInt32(const FSteamStatHandle& Handle, int32 Data) const { return SteamUserStats()->SetStat(Handle.Get(), Data); }
+	bool SetStatFloat(const FSteamStatHandle& Handle, float Data) const { return SteamUserStats()->SetStat(Handle.Get(), Data); }
+	bool UpdateAvgRateStat(const FSteamStatHandle& Handle, float CountThisSession, float SessionLength) const { return SteamUserStats()->UpdateAvgRateStat(Handle.Get(), CountThisSession, (double)SessionLength); }
+
+	/** Shadow store */
+
+	/**
+	 * Resolves a stat or achievement to a slot of the local shadow store. The name is converted to UTF-8 once here, every later access only uses the slot.
+	 * Slot writes only touch the shadow store. Dirty slots are pushed to Steam and stored every StatsFlushInterval seconds (see USteamBridgeSettings), unlocked achievements are stored right away.
+	 *
+	 * @param const FString & Name - The 'API Name' of the stat or achievement.
+	 * @param ESteamStatSlotType Type - The type of the stat in the Steamworks Partner backend.
+	 * @return int32 - The slot. Resolving the same name again returns the same slot. INDEX_NONE if the name was already resolved with another type.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "SteamBridgeCore|UserStats")
+	int32 ResolveStatSlot(const FString& Name, ESteamStatSlotType Type);
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	void SetStatSlotInt32(int32 Slot, int32 Value);
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	void AddStatSlotInt32(int32 Slot, int32 Delta);
+
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	void SetStatSlotFloat(int32 Slot, float Value);
+
+	/**
+	 * Unlocks the achievement of a slot. Unlocks count as important events and are stored without waiting for the flush interval.
+	 *
+	 * @param int32 Slot - A slot resolved with ESteamStatSlotType::Achievement.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	void UnlockAchievementSlot(int32 Slot);
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UserStats")
+	int32 GetStatSlotInt32(int32 Slot) const { return m_StatSlots.IsValidIndex(Slot) ? m_StatSlots[Slot].IntValue : 0; }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UserStats")
+	float GetStatSlotFloat(int32 Slot) const { return m_StatSlots.IsValidIndex(Slot) ? m_StatSlots[Slot].FloatValue : 0.0f; }
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UserStats")
+	bool GetAchievementSlot(int32 Slot) const { return m_StatSlots.IsValidIndex(Slot) && m_StatSlots[Slot].IntValue != 0; }
+
+	/**
+	 * Stores the shadow store as soon as possible instead of at the next flush interval, e.g. at the end of a match or before quitting.
+	 * Still waits for a pending StoreStats or a rate limit backoff to finish.
+	 *
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	void FlushStatSlots();
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UserStats")
+	bool HasUnstoredStatSlots() const { return m_NumDirtySlots > 0 || m_bStorePending || m_bStoreInFlight; }
+
+	/** Score upload queue */
+
+	/**
+	 * Queues a score instead of uploading it right away.
+	 * Scores queued for the same leaderboard with KeepBest are coalesced to the best one. Uploads are spread out to stay under Steam's limit of 10 per 10 minutes and retried with backoff when they fail.
+	 * The queue is saved to disk, scores that weren't uploaded before the game quit or crashed are uploaded on the next launch
+	 * once the stats were received, a leaderboard was looked up or a score was queued.
+	 * Results are reported by OnLeaderboardScoreUploaded like with UploadLeaderboardScore.
+	 *
+	 * @param FSteamLeaderboard SteamLeaderboard - A leaderboard handle obtained from FindLeaderboard or FindOrCreateLeaderboard.
+	 * @param ESteamLeaderboardUploadScoreMethod LeaderboardUploadScoreMethod - Do you want to force the score to change, or keep the previous score if it was better?
+	 * @param int32 Score - The score to upload.
+	 * @param const TArray<int32> & ScoreDetails - Optional: Array containing the details surrounding the unlocking of this score.
+	 * @return void
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SteamBridgeCore|UserStats")
+	void QueueLeaderboardScore(FSteamLeaderboard SteamLeaderboard, ESteamLeaderboardUploadScoreMethod LeaderboardUploadScoreMethod, int32 Score, const TArray<int32>& ScoreDetails);
+
+	UFUNCTION(BlueprintPure, Category = "SteamBridgeCore|UserStats")
+	int32 GetNumQueuedLeaderboardScores() const { return m_QueuedScores.Num(); }
+
 	/** Delegates */
 
 	/** Called when the global achievement percentages have been received from the server. */
@@ -636,7 +762,7 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|UserStats", meta = (DisplayName = "OnGlobalStatsReceived"))
 	FOnGlobalStatsReceivedDelegate m_OnGlobalStatsReceived;
 
-	/** Result when finding a leaderboard. */
+	/** Result when finding a leaderboard. Also called for the lookups the score upload queue makes for scores loaded from disk. */
 	UPROPERTY(BlueprintAssignable, Category = "SteamBridgeCore|UserStats", meta = (DisplayName = "OnLeaderboardFindResult"))
 	FOnLeaderboardFindResultDelegate m_OnLeaderboardFindResult;
 
@@ -684,6 +810,74 @@ public:
 
 protected:
 private:
+	struct FStatSlot
+	{
+		FSteamStatHandle Handle;
+		ESteamStatSlotType Type;
+		int32 IntValue;  // Also holds the unlock state of achievements
+		float FloatValue;
+	};
+
+	void MarkSlotDirty(int32 Slot, bool bImportant);
+	void ReadSlotFromSteam(FStatSlot& StatSlot) const;
+	bool TickStatSlots(float DeltaTime);
+
+	void BuildAchievementHandles();
+	void BuildAchievementPercentages();
+
+	TMap<FString, FSteamStatHandle> m_StatHandles;
+	TArray<FSteamStatHandle> m_AchievementHandles;
+	TArray<FSteamAchievementPercentage> m_AchievementPercentages;
+
+	TArray<FStatSlot> m_StatSlots;
+	TMap<FString, int32> m_StatSlotIndices;
+	TBitArray<> m_DirtySlots;
+	int32 m_NumDirtySlots;
+
+	// Slots were pushed to Steam but StoreStats still has to be (re)called
+	bool m_bStorePending;
+	bool m_bStoreRequested;
+	bool m_bStoreInFlight;
+	bool m_bStatsReceived;
+	double m_NextStoreTime;
+	double m_BackoffUntil;
+	double m_StoreIssuedTime;
+	float m_StoreBackoff;
+
+	FDelegateHandle m_StatSlotsTickHandle;
+
+	struct FQueuedScore
+	{
+		FString LeaderboardName;  // Handles are only valid for a session, scores loaded from disk are matched to their leaderboard by name
+		SteamLeaderboard_t Leaderboard;
+		ELeaderboardUploadScoreMethod Method;
+		int32 Score;
+		TArray<int32> Details;
+		bool bInFlight;
+	};
+
+	void LoadQueuedScores();
+	void SaveQueuedScores();
+	void StartScoreUploads();
+	bool TickScoreUploads(float DeltaTime);
+	void OnQueuedLeaderboardFound(LeaderboardFindResult_t* pParam, bool bIOFailure);
+	void OnQueuedScoreUploaded(LeaderboardScoreUploaded_t* pParam, bool bIOFailure);
+
+	TArray<FQueuedScore> m_QueuedScores;
+	TArray<double> m_ScoreUploadTimes;
+	FString m_ResolvingLeaderboardName;
+	double m_NextScoreUploadTime;
+	double m_ScoreUploadStartTime;
+	double m_ResolveStartTime;
+	float m_ScoreUploadBackoff;
+	bool m_bQueuedScoresLoaded;
+
+	// The queue waits on its own calls so finds and uploads the game makes itself are never mistaken for the queue's
+	CCallResult<USteamUserStats, LeaderboardFindResult_t> m_ScoreQueueFindCall;
+	CCallResult<USteamUserStats, LeaderboardScoreUploaded_t> m_ScoreQueueUploadCall;
+
+	FDelegateHandle m_ScoreUploadTickHandle;
+
 	STEAM_CALLBACK_MANUAL(USteamUserStats, OnGlobalAchievementPercentagesReady, GlobalAchievementPercentagesReady_t, OnGlobalAchievementPercentagesReadyCallback);
 	STEAM_CALLBACK_MANUAL(USteamUserStats, OnGlobalStatsReceived, GlobalStatsReceived_t, OnGlobalStatsReceivedCallback);
 	STEAM_CALLBACK_MANUAL(USteamUserStats, OnLeaderboardFindResult, LeaderboardFindResult_t, OnLeaderboardFindResultCallback);
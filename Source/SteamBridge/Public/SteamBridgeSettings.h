@@ -15,8 +15,38 @@ class STEAMBRIDGE_API USteamBridgeSettings final : public UObject
 	GENERATED_BODY()
 	
 public:
+	USteamBridgeSettings();
+
 	UPROPERTY(EditAnywhere, config, Category = General)
 	bool bTest;
 
+	/** Seconds between the StoreStats calls made by the stats shadow store while stats keep changing. Achievements are stored right away. */
+	UPROPERTY(EditAnywhere, config, Category = Stats, meta = (ClampMin = "1.0"))
+	float StatsFlushInterval;
+
+	/** Seconds to wait before retrying StoreStats after Steam reported it was rate limited or busy. Doubled for every failure in a row. */
+	UPROPERTY(EditAnywhere, config, Category = Stats, meta = (ClampMin = "1.0"))
+	float StatsMinBackoff;
+
+	/** The longest the stats shadow store waits between StoreStats retries. */
+	UPROPERTY(EditAnywhere, config, Category = Stats, meta = (ClampMin = "1.0"))
+	float StatsMaxBackoff;
+
+	/** Leaderboards looked up by USteamLeaderboardResolver::WarmUpLeaderboards so their handles are cached before they're shown. */
+	UPROPERTY(EditAnywhere, config, Category = Leaderboards)
+	TArray<FString> WarmUpLeaderboards;
+
+	/** Cloud files USteamRemoteStorage never forgets to make space for a write, wildcards are allowed (e.g. "profile*.sav"). */
+	UPROPERTY(EditAnywhere, config, Category = RemoteStorage)
+	TArray<FString> CloudCriticalFiles;
+
+	/** Bytes of Steam Cloud quota kept free. Least recently used files are forgotten when a write would leave less than this. */
+	UPROPERTY(EditAnywhere, config, Category = RemoteStorage, meta = (ClampMin = "0"))
+	int64 CloudReserveBytes;
+
+	/** The most bytes of response bodies USteamHTTPCache keeps on disk. Least recently used responses are deleted past it. */
+	UPROPERTY(EditAnywhere, config, Category = HTTP, meta = (ClampMin = "0"))
+	int64 HTTPCacheMaxBytes;
+
 	// #TODO Implement OSS Steam settings to remove the requirement of setting the info via text editor
 };
@@ -7,6 +7,30 @@
 #include "SteamStructs.h"
 #include "SteamBridgeUtils.generated.h"
 
+/**
+ * A grow-only scratch buffer used for Steam out-params. Sized from the SDK limits, allocated once and reused across calls.
+ */
+struct STEAMBRIDGE_API FSteamScratchBuffer
+{
+	/**
+	 * Returns a zeroed region of at least Size bytes. The pointer is only valid until the next call.
+	 */
+	char* Reserve(int32 Size)
+	{
+		if (m_Data.Num() < Size)
+		{
+			m_Data.SetNumUninitialized(Size, false);
+		}
+		FMemory::Memzero(m_Data.GetData(), Size);
+		return m_Data.GetData();
+	}
+
+	int32 GetCapacity() const { return m_Data.Num(); }
+
+private:
+	TArray<char> m_Data;
+};
+
 /**
  *
  */
@@ -20,6 +44,12 @@ public:
 
 	static FString ConvertIPToString(uint32 IP);
 
+	/**
+	 * Decodes a UTF-8 buffer written by Steam straight into Dest, reusing Dest's allocation.
+	 * Never reads past BufferSize even if Steam didn't null terminate the buffer.
+	 */
+	static void ConvertUTF8ToString(const char* Buffer, int32 BufferSize, FString& Dest);
+
 	UFUNCTION(BlueprintCallable, Category = "Steam|USteamBridgeUtils")
 	static FString GetSteamIDAsString(const FSteamID& SteamID);
 
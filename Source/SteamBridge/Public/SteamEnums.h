@@ -1182,4 +1182,20 @@ enum class ESteamItemStatistic : uint8
 	NumComments = 10,
 	NumSecondsPlayedDuringTimePeriod = 11,
 	NumPlaytimeSessionsDuringTimePeriod = 12,
+};
+
+UENUM(BlueprintType)
+enum class ESteamStatSlotType : uint8
+{
+	Int32 = 0,
+	Float = 1,
+	Achievement = 2,
+};
+
+UENUM(BlueprintType)
+enum class ESteamUGCReadAction : uint8
+{
+	ContinueReadingUntilFinished = 0 UMETA(DisplayName = "ContinueReadingUntilFinished"),
+	ContinueReading = 1 UMETA(DisplayName = "ContinueReading"),
+	Close = 2 UMETA(DisplayName = "Close")
 };
\ No newline at end of file
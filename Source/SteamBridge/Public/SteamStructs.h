@@ -530,3 +530,265 @@ struct STEAMBRIDGE_API FSteamItemPriceData
 	FSteamItemPriceData() {}
 	FSteamItemPriceData(FSteamItemDef def, int64 currentPrice, int64 basePrice) : ItemDef(def), CurrentPrice(currentPrice), BasePrice(basePrice) {}
 };
+
+USTRUCT(BlueprintType)
+struct STEAMBRIDGE_API FSteamUGCInstallEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	FPublishedFileId PublishedFileID;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 ItemState;  // EItemState flags from GetItemState
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Priority;  // Higher priorities are downloaded first
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 BytesDownloaded;
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 BytesTotal;
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 SizeOnDisk;
+
+	UPROPERTY(BlueprintReadOnly)
+	FString InstallFolder;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 TimeStamp;  // time when the installed content was last updated
+
+	UPROPERTY(BlueprintReadOnly)
+	ESteamResult LastResult;  // result of the last DownloadItemResult_t for this item
+
+	bool IsInstalled() const { return (ItemState & k_EItemStateInstalled) != 0 && (ItemState & k_EItemStateNeedsUpdate) == 0; }
+
+	FSteamUGCInstallEntry() :
+		PublishedFileID(0), ItemState(0), Priority(0), BytesDownloaded(0), BytesTotal(0), SizeOnDisk(0), InstallFolder(""), TimeStamp(0), LastResult(ESteamResult::None) {}
+	FSteamUGCInstallEntry(FPublishedFileId id) :
+		PublishedFileID(id), ItemState(0), Priority(0), BytesDownloaded(0), BytesTotal(0), SizeOnDisk(0), InstallFolder(""), TimeStamp(0), LastResult(ESteamResult::None) {}
+};
+
+USTRUCT(BlueprintType)
+struct STEAMBRIDGE_API FSteamUGCContentScanResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	FPublishedFileId PublishedFileID;
+
+	UPROPERTY(BlueprintReadOnly)
+	FString InstallFolder;
+
+	UPROPERTY(BlueprintReadOnly)
+	FString ContentHash;  // SHA1 (hex) over every file's relative path and MD5
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumFiles;
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 TotalBytes;
+
+	UPROPERTY(BlueprintReadOnly)
+	TArray<FString> PakFiles;  // paks with a valid footer
+
+	UPROPERTY(BlueprintReadOnly)
+	TArray<FString> InvalidPakFiles;  // .pak files that failed validation and weren't mounted
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumMountedPaks;
+
+	FSteamUGCContentScanResult() :
+		PublishedFileID(0), InstallFolder(""), ContentHash(""), NumFiles(0), TotalBytes(0), NumMountedPaks(0) {}
+	FSteamUGCContentScanResult(FPublishedFileId id, const FString& folder) :
+		PublishedFileID(id), InstallFolder(folder), ContentHash(""), NumFiles(0), TotalBytes(0), NumMountedPaks(0) {}
+};
+
+USTRUCT(BlueprintType)
+struct STEAMBRIDGE_API FSteamUGCItemUpload
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadWrite)
+	FPublishedFileId PublishedFileID;
+
+	UPROPERTY(BlueprintReadWrite)
+	FString ContentFolder;  // absolute path, staged before it's handed to SetItemContent
+
+	UPROPERTY(BlueprintReadWrite)
+	FString PreviewFile;  // optional, absolute path
+
+	UPROPERTY(BlueprintReadWrite)
+	FString ChangeNote;
+
+	FSteamUGCItemUpload() :
+		PublishedFileID(0), ContentFolder(""), PreviewFile(""), ChangeNote("") {}
+	FSteamUGCItemUpload(FPublishedFileId id, const FString& contentFolder, const FString& previewFile, const FString& changeNote) :
+		PublishedFileID(id), ContentFolder(contentFolder), PreviewFile(previewFile), ChangeNote(changeNote) {}
+};
+
+USTRUCT(BlueprintType)
+struct STEAMBRIDGE_API FSteamUGCStagingStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 FilesLinked;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 FilesCopied;  // files that couldn't be hard linked (e.g. the staging folder is on another volume)
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 FilesSkipped;  // files already staged by an earlier run
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 FilesRemoved;
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 BytesCopied;
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bSucceeded;
+
+	FSteamUGCStagingStats() :
+		FilesLinked(0), FilesCopied(0), FilesSkipped(0), FilesRemoved(0), BytesCopied(0), bSucceeded(false) {}
+};
+
+USTRUCT(BlueprintType)
+struct STEAMBRIDGE_API FSteamUGCUploadProgress
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	FPublishedFileId PublishedFileID;
+
+	UPROPERTY(BlueprintReadOnly)
+	ESteamItemUpdateStatus Status;
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 BytesProcessed;
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 BytesTotal;
+
+	UPROPERTY(BlueprintReadOnly)
+	float BytesPerSecond;  // measured between the last two progress polls
+
+	FSteamUGCUploadProgress() :
+		PublishedFileID(0), Status(ESteamItemUpdateStatus::Invalid), BytesProcessed(0), BytesTotal(0), BytesPerSecond(0.0f) {}
+	FSteamUGCUploadProgress(FPublishedFileId id) :
+		PublishedFileID(id), Status(ESteamItemUpdateStatus::Invalid), BytesProcessed(0), BytesTotal(0), BytesPerSecond(0.0f) {}
+};
+
+USTRUCT(BlueprintType)
+struct STEAMBRIDGE_API FSteamItemRecipe
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	TArray<FSteamItemDef> Materials;
+
+	UPROPERTY(BlueprintReadOnly)
+	TArray<int32> Quantities;  // quantity of each entry in Materials
+
+	FSteamItemRecipe() {}
+};
+
+USTRUCT(BlueprintType)
+struct STEAMBRIDGE_API FSteamInventoryVerification
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 RequestID;
+
+	UPROPERTY(BlueprintReadOnly)
+	FSteamID SteamID;  // the player the serialized result was expected to belong to
+
+	UPROPERTY(BlueprintReadOnly)
+	ESteamResult Result;  // status of the deserialized result
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bVerified;  // the result is valid, not expired and belongs to SteamID
+
+	UPROPERTY(BlueprintReadOnly)
+	TArray<FSteamItemDetails> Items;  // only filled in when bVerified is true
+
+	FSteamInventoryVerification() :
+		RequestID(0), SteamID(0), Result(ESteamResult::None), bVerified(false) {}
+	FSteamInventoryVerification(int32 requestID, FSteamID steamID) :
+		RequestID(requestID), SteamID(steamID), Result(ESteamResult::None), bVerified(false) {}
+};
+
+/** A stat or achievement name that is encoded to UTF-8 once so stats calls don't have to convert it every time. See USteamUserStats::MakeStatHandle. */
+USTRUCT(BlueprintType)
+struct STEAMBRIDGE_API FSteamStatHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	FString Name;  // the 'API Name' of the stat or achievement
+
+	TArray<ANSICHAR, TInlineAllocator<k_cchStatNameMax>> UTF8Name;  // null terminated and stored inline, copying it doesn't allocate but copying Name does
+
+	const char* Get() const { return UTF8Name.Num() > 0 ? UTF8Name.GetData() : ""; }
+	bool IsValid() const { return UTF8Name.Num() > 1; }
+
+	FSteamStatHandle() {}
+	explicit FSteamStatHandle(const FString& name) :
+		Name(name)
+	{
+		FTCHARToUTF8 Converted(*name);
+		UTF8Name.Append(Converted.Get(), Converted.Length());
+		UTF8Name.Add('\0');
+	}
+};
+
+USTRUCT(BlueprintType)
+struct STEAMBRIDGE_API FSteamAchievementPercentage
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	FSteamStatHandle Achievement;
+
+	UPROPERTY(BlueprintReadOnly)
+	float Percent;  // percentage of players that unlocked the achievement, from 0 to 100
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bAchieved;  // whether the current user unlocked the achievement
+
+	FSteamAchievementPercentage() :
+		Percent(0.0f), bAchieved(false) {}
+	FSteamAchievementPercentage(const FSteamStatHandle& achievement, float percent, bool achieved) :
+		Achievement(achievement), Percent(percent), bAchieved(achieved) {}
+};
+
+/** An entry of the cloud file manifest cached by USteamRemoteStorage. */
+USTRUCT(BlueprintType)
+struct STEAMBRIDGE_API FSteamCloudFile
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	FString FileName;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Size;  // in bytes
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 Timestamp;  // last time the file was written, in Unix epoch format
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bPersisted;  // false once the file was forgotten and only exists on the local disk
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bCritical;  // critical files are never forgotten to make space
+
+	FSteamCloudFile() :
+		Size(0), Timestamp(0), bPersisted(false), bCritical(false) {}
+	FSteamCloudFile(const FString& fileName, int32 size, int64 timestamp, bool persisted, bool critical) :
+		FileName(fileName), Size(size), Timestamp(timestamp), bPersisted(persisted), bCritical(critical) {}
+};